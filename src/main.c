@@ -4,62 +4,278 @@
 #include <ti/real.h>
 #include <fileioc.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <stdbool.h>
 #include <math.h>
+#include <float.h>
 #include <string.h>
 #include <stdarg.h>
 #include <stdint.h>
+#include <limits.h>
+#include <time.h>
 
 /* =================== Config =================== */
-#define EPS 1e-10
+/* Engine number type. make WIDE=YES builds on the toolchain's 64-bit long
+   double; the default double is a 32-bit float on the CE. */
+#ifdef GJ_WIDE
+typedef long double real;
+#define REAL_EPS  LDBL_EPSILON
+#define REAL_MIN  LDBL_MIN
+#define REAL_NAME "long double"
+#define r_fabs    fabsl
+#define r_floor   floorl
+#define r_round   roundl
+#define r_strtod  strtold
+#else
+typedef double real;
+#define REAL_EPS  DBL_EPSILON
+#define REAL_MIN  DBL_MIN
+#define REAL_NAME "double"
+#define r_fabs    fabs
+#define r_floor   floor
+#define r_round   round
+#define r_strtod  strtod
+#endif
+
+#define TOL_ULPS 8            /* pivot/zero tolerance: TOL_ULPS * n * REAL_EPS * |A|_inf */
 #define MAX_R 3               /* supports 2x3 or 3x4 augmented */
+#ifndef GJ_NO_VERIFY         /* make VERIFY=NO */
+#define VERIFY 1              /* log residuals of x against the input */
+#else
+#define VERIFY 0
+#endif
+#define RESID_TOL (64 * REAL_EPS)     /* relative to |A||x| + |b| */
+#define PIVOT_EARLY 0.1       /* early pivot must be this fraction of its row */
+#ifdef GJ_COST_REPORT        /* make COST=YES */
+#define COST_REPORT 1         /* time double vs long double on each input */
+#else
+#define COST_REPORT 0
+#endif
+#define COST_REPS 16
+#ifdef GJ_INTERVALS          /* make INTERVALS=YES */
+#define INTERVALS 1           /* log guaranteed bounds on x */
+#else
+#define INTERVALS 0
+#endif
 #define MAX_C (MAX_R + 1)
 
 #define MAX_LINES 280         /* for step logs */
 #define LINE_CHARS 56
+#define MAX_LOG_VALS 1024     /* numeric arguments of logged lines */
+#define CACHE_LINES 64        /* formatted lines kept for the viewer */
+
+/* =================== Scratch RAM =================== */
+/* GraphX's two 8bpp buffers fill all 153600 bytes of LCD RAM, so there is no
+   spare VRAM to borrow. pixelShadow, pixelShadow2 and cmdPixelShadow are
+   3 x 8400 contiguous bytes the OS only uses for the graph screen; they are
+   ours while the program runs, so the step log and the viewer's line cache
+   live there instead of .bss. */
+#define SCRATCH       ((uint8_t *)os_PixelShadow)
+#define SCRATCH_SIZE  (3 * 8400)
 
 /* =================== Globals =================== */
-static char LOGBUF[MAX_LINES][LINE_CHARS];
 static int  log_count = 0;
 
 /* =================== Logging =================== */
+/* The log keeps numbers, not text. Each line is a format plus its arguments:
+   %d takes an int, %c a char, %v a real shown in the current display mode, %e a real
+   shown as %.3e whatever the mode (for residuals and tolerances), %L and %U
+   a real rounded down or up (for bounds). A NULL
+   format is a matrix row of ints[0] values. Text is only made for lines the
+   viewer shows (see log_text), so the display mode can change at any time. */
+typedef struct {
+    const char *fmt;
+    int16_t  ints[4];
+    uint16_t val;       /* index of the first value in LOGVALS */
+} log_rec;
+
+#define LOGVALS   ((real *)SCRATCH)
+#define LOGRECS   ((log_rec *)(LOGVALS + MAX_LOG_VALS))
+#define LINECACHE ((char (*)[LINE_CHARS])(LOGRECS + MAX_LINES))
+_Static_assert(MAX_LOG_VALS*sizeof(real) + MAX_LINES*sizeof(log_rec) + CACHE_LINES*LINE_CHARS
+               <= SCRATCH_SIZE, "step log does not fit in scratch RAM");
+
+static int log_vals = 0;
+
 static void log_line(const char *fmt, ...) {
-    if (log_count >= MAX_LINES) return;
+    if (log_count >= MAX_LINES || log_vals + MAX_C > MAX_LOG_VALS) return;
+    log_rec *rec = &LOGRECS[log_count++];
+    int ni = 0;
+
+    rec->fmt = fmt;
+    rec->val = (uint16_t)log_vals;
     va_list ap; va_start(ap, fmt);
-    vsnprintf(LOGBUF[log_count], LINE_CHARS, fmt, ap);
+    for (const char *p = fmt; *p; ++p) {
+        if (*p != '%') continue;
+        if (*++p == 'd' || *p == 'c') { int x = va_arg(ap, int); if (ni < 4) rec->ints[ni++] = (int16_t)x; }
+        else if (*p == 'v' || *p == 'e' || *p == 'L' || *p == 'U') { real x = va_arg(ap, real); if (log_vals < rec->val + MAX_C) LOGVALS[log_vals++] = x; }
+        else if (!*p) break;
+    }
     va_end(ap);
-    log_count++;
+}
+
+static void log_row(const real *row, int cols) {
+    if (log_count >= MAX_LINES || log_vals + cols > MAX_LOG_VALS) return;
+    log_rec *rec = &LOGRECS[log_count++];
+
+    rec->fmt = NULL;
+    rec->ints[0] = (int16_t)cols;
+    rec->val = (uint16_t)log_vals;
+    memcpy(&LOGVALS[log_vals], row, cols * sizeof(real));
+    log_vals += cols;
+}
+
+/* =================== Operation index =================== */
+/* Each logged row operation is indexed by kind and rows (1-based, as shown;
+   a block's rows by their equation) when it is logged, so the viewer's
+   search never scans formatted text. */
+enum { OP_SWAP, OP_SCALE, OP_ELIM, OP_SINGULAR, OP_FACTOR, OP_ANY };  /* FACTOR: an LDL^T d_j */
+#define MAX_OPS 48
+
+typedef struct {
+    int     line;       /* log line of the "Iter" header */
+    uint8_t kind;
+    uint8_t dst, src;   /* target row, source row (0 = none) */
+    real    f;          /* elimination factor or scale, exactly as applied */
+} op_entry;
+
+static op_entry OPS[MAX_OPS];
+static int op_count = 0;
+
+/* call right before logging the operation's header line */
+static void index_op(uint8_t kind, int dst, int src, real f) {
+    if (op_count >= MAX_OPS) return;
+    op_entry *e = &OPS[op_count++];
+    e->line = log_count; e->kind = kind; e->dst = (uint8_t)dst; e->src = (uint8_t)src;
+    e->f = f;
+}
+
+static bool op_matches(const op_entry *e, int kind, int row) {
+    if (kind != OP_ANY && e->kind != kind) return false;
+    return row == 0 || e->dst == row || e->src == row;
+}
+
+/* line of the nearest match after (dir > 0) or before (dir < 0) `from`; -1 if none */
+static int find_op(int from, int dir, int kind, int row) {
+    if (dir > 0) {
+        for (int i = 0; i < op_count; ++i)
+            if (OPS[i].line > from && op_matches(&OPS[i], kind, row)) return OPS[i].line;
+    } else {
+        for (int i = op_count-1; i >= 0; --i)
+            if (OPS[i].line < from && op_matches(&OPS[i], kind, row)) return OPS[i].line;
+    }
+    return -1;
+}
+
+/* =================== Number display =================== */
+/* How every logged value is shown; the viewer cycles both settings live. */
+enum { DISP_FRAC, DISP_MIXED, DISP_DEC, DISP_SCI, DISP_MODES };
+static const char *const DISP_NAMES[DISP_MODES] = { "frac", "mixed", "dec", "sci" };
+static const int16_t MAX_DENS[] = { 1000, 10000, 10, 100 };
+#define N_MAX_DENS ((int)(sizeof(MAX_DENS) / sizeof(MAX_DENS[0])))
+
+static uint8_t disp_mode = DISP_FRAC;
+static uint8_t disp_den = 0;    /* index into MAX_DENS */
+static real disp_zero = 1e-12;  /* shown as 0 at or below this; the solve's tol */
+
+/* =================== Golden op log =================== */
+/* Canonical form of a solve for regression checks: the input matrix and each
+   operation's kind, rows and exact factor bits, independent of how the log is
+   formatted. STO> in the viewer saves it as the GJGOLD AppVar, and every
+   finished solve is diffed against that op by op.
+
+   Layout: "GJOP", version, sizeof(real), rows, cols, op count (LE16),
+   rows*cols raw reals, then per op: kind, dst, src, raw factor. */
+#define GOLD_VAR     "GJGOLD"
+#define GOLD_VERSION 1
+
+enum { GOLD_NONE, GOLD_OTHER, GOLD_SAME, GOLD_DIFF };
+
+static void gold_header(uint8_t hdr[10], int rows, int cols, int ops) {
+    memcpy(hdr, "GJOP", 4);
+    hdr[4] = GOLD_VERSION; hdr[5] = sizeof(real);
+    hdr[6] = (uint8_t)rows; hdr[7] = (uint8_t)cols;
+    hdr[8] = (uint8_t)ops;  hdr[9] = (uint8_t)(ops >> 8);
+}
+
+static bool gold_save(real A0[MAX_R][MAX_C], int rows, int cols) {
+    uint8_t hdr[10];
+    uint8_t h = ti_Open(GOLD_VAR, "w");
+    if (!h) return false;
+
+    gold_header(hdr, rows, cols, op_count);
+    ti_Write(hdr, sizeof(hdr), 1, h);
+    for (int i = 0; i < rows; ++i) ti_Write(A0[i], sizeof(real), cols, h);
+    for (int i = 0; i < op_count; ++i) {
+        ti_Write(&OPS[i].kind, 1, 3, h);   /* kind, dst, src are adjacent */
+        ti_Write(&OPS[i].f, sizeof(real), 1, h);
+    }
+    ti_Close(h);
+    return true;
+}
+
+/* structural diff against GJGOLD; *at is the first divergent op */
+static int gold_diff(real A0[MAX_R][MAX_C], int rows, int cols, int *at) {
+    uint8_t hdr[10], want[10];
+    uint8_t h = ti_Open(GOLD_VAR, "r");
+    if (!h) return GOLD_NONE;
+
+    int res = GOLD_OTHER;
+    gold_header(want, rows, cols, 0);
+    if (ti_Read(hdr, sizeof(hdr), 1, h) != 1 || memcmp(hdr, want, 8) != 0) goto out;
+    for (int i = 0; i < rows; ++i) {
+        real row[MAX_C];
+        if (ti_Read(row, sizeof(real), cols, h) != (size_t)cols ||
+            memcmp(row, A0[i], cols * sizeof(real)) != 0) goto out;
+    }
+
+    int ops = hdr[8] | hdr[9] << 8, i;
+    for (i = 0; i < ops && i < op_count; ++i) {
+        uint8_t rec[3]; real f;
+        if (ti_Read(rec, 1, 3, h) != 3 || ti_Read(&f, sizeof(real), 1, h) != 1) break;
+        if (memcmp(rec, &OPS[i].kind, 3) != 0 || memcmp(&f, &OPS[i].f, sizeof(real)) != 0) break;
+    }
+    *at = i;
+    res = (i == ops && i == op_count) ? GOLD_SAME : GOLD_DIFF;
+out:
+    ti_Close(h);
+    return res;
 }
 
 /* =================== Fractions (smart output) =================== */
 /* print "nice" fractions when possible; else compact decimal */
-static void format_frac(double x, char out[LINE_CHARS]) {
+static void format_frac(real x, char out[LINE_CHARS]) {
     if (!isfinite(x)) { snprintf(out, LINE_CHARS, "%s", isnan(x) ? "NaN" : "inf"); return; }
+    if (disp_mode == DISP_SCI) { snprintf(out, LINE_CHARS, "%.3e", (double)x); return; }
 
-    /* squash tiny noise to zero */
-    if (fabs(x) < 1e-14) { snprintf(out, LINE_CHARS, "0"); return; }
+    /* squash noise to zero, relative to the scale of the input */
+    if (r_fabs(x) <= disp_zero) { snprintf(out, LINE_CHARS, "0"); return; }
+    if (disp_mode == DISP_DEC) { snprintf(out, LINE_CHARS, "%.6g", (double)x); return; }
+
+    /* too small for any fraction within the denominator cap */
+    const int64_t MAX_DEN = MAX_DENS[disp_den];  /* 1000 keeps things readable on-screen */
+    if (r_fabs(x) < 0.5 / MAX_DEN) { snprintf(out, LINE_CHARS, "%.6g", (double)x); return; }
 
     /* close to integer? */
-    double rintx = round(x);
-    if (fabs(x - rintx) < 1e-12) { snprintf(out, LINE_CHARS, "%.0f", rintx); return; }
+    real rintx = r_round(x);
+    if (r_fabs(x - rintx) < 1e-12) { snprintf(out, LINE_CHARS, "%.0f", (double)rintx); return; }
 
     /* continued-fraction approximation with cap on denominator */
-    const int64_t MAX_DEN = 1000;  /* <= 1000 keeps things readable on-screen */
-    double ax = fabs(x), v = ax;
+    real ax = r_fabs(x), v = ax;
     int64_t p0=0, q0=1, p1=1, q1=0;
 
     for (int it=0; it<32; ++it) {
-        double a = floor(v);
+        real a = r_floor(v);
         int64_t p = (int64_t)a * p1 + p0;
         int64_t q = (int64_t)a * q1 + q0;
 
         if (q > MAX_DEN) break;
 
-        double approx = (double)p / (double)q;
-        if (fabs(approx - ax) < 5e-8) { p0=p; q0=q; p1=0; q1=0; break; }
+        real approx = (real)p / (real)q;
+        if (r_fabs(approx - ax) < 5e-8) { p0=p; q0=q; p1=0; q1=0; break; }
 
         p0 = p1; q0 = q1; p1 = p; q1 = q;
-        double r = v - a;
+        real r = v - a;
         if (r < 1e-15) { p0=p; q0=q; p1=0; q1=0; break; }
         v = 1.0 / r;
     }
@@ -70,7 +286,7 @@ static void format_frac(double x, char out[LINE_CHARS]) {
 
     if (den > MAX_DEN || den == 0) {
         /* fall back to compact decimal */
-        snprintf(out, LINE_CHARS, "%.6g", x);
+        snprintf(out, LINE_CHARS, "%.6g", (double)x);
         return;
     }
 
@@ -79,20 +295,50 @@ static void format_frac(double x, char out[LINE_CHARS]) {
     if (den < 0) { den = -den; num = -num; }
 
     if (den == 1) snprintf(out, LINE_CHARS, "%lld", (long long)num);
+    else if (disp_mode == DISP_MIXED && (num > den || -num > den))
+        snprintf(out, LINE_CHARS, "%lld_%lld/%lld", (long long)(num / den),
+                 (long long)(num < 0 ? -(num % den) : num % den), (long long)den);
     else          snprintf(out, LINE_CHARS, "%lld/%lld", (long long)num, (long long)den);
 }
 
-static void small_val(double v, char out[16]) {
+static void small_val(real v, char out[16]) {
     char tmp[LINE_CHARS];
-    /* zero-out ultratiny */
-    if (fabs(v) < 1e-12) v = 0.0;
+    /* zero-out noise, except in sci mode, which is for magnitudes */
+    if (disp_mode != DISP_SCI && r_fabs(v) <= disp_zero) v = 0.0;
     format_frac(v, tmp);
     snprintf(out, 16, "%s", tmp);
 }
 
+/* x rounded toward +inf if up, else toward -inf: a printed bound must still
+   contain what it bounds, so no fraction or %g rounding. The digits are what
+   the double cast keeps, at most 10. */
+#define BOUND_DIGITS (DBL_DIG < 10 ? DBL_DIG : 10)
+static void format_bound(real x, bool up, char out[24]) {
+    if (isnan(x)) { snprintf(out, 24, "NaN"); return; }
+    real y = x;
+    for (;;) {
+        if (!isfinite((double)y)) { snprintf(out, 24, "%s", up ? "inf" : "-inf"); return; }
+        snprintf(out, 24, "%.*e", BOUND_DIGITS-1, (double)y);
+        real back = r_strtod(out, NULL);
+        if (up ? back >= x : back <= x) return;
+        /* rounded the wrong way: one unit in the last digit further out */
+        real unit = pow(10, atoi(strchr(out, 'e') + 1) - (BOUND_DIGITS-1));
+        y = up ? back + unit : back - unit;
+    }
+}
+
 /* =================== Homescreen input helpers =================== */
 /* Parse decimal or fraction "a/b" (signs allowed). */
-static bool parse_number(const char *s, double *out) {
+/* all of s, trailing spaces aside, as one decimal */
+static bool parse_decimal(const char *s, real *out) {
+    char *end;
+    *out = r_strtod(s, &end);
+    if (end == s) return false;
+    while (*end == ' ' || *end == '\t') end++;
+    return !*end;
+}
+
+static bool parse_number(const char *s, real *out) {
     if (!s) return false;
     while (*s==' ' || *s=='\t') s++;
     if (!*s) { *out = 0.0; return true; }
@@ -105,25 +351,24 @@ static bool parse_number(const char *s, double *out) {
         memcpy(numbuf, s, nlen);
         snprintf(denbuf, sizeof(denbuf), "%s", slash+1);
 
-        double num = strtod(numbuf, NULL);
-        double den = strtod(denbuf, NULL);
-        if (fabs(den) < 1e-18) return false;
+        real num, den;
+        if (!parse_decimal(numbuf, &num) || !parse_decimal(denbuf, &den)) return false;
+        if (r_fabs(den) < 1e-18) return false;
         *out = num / den;
         return true;
     } else {
-        *out = strtod(s, NULL);
-        return true;
+        return parse_decimal(s, out);
     }
 }
 
-static double prompt_number_hs(const char *prompt) {
+static real prompt_number_hs(const char *prompt) {
     char buf[32];
     while (1) {
         os_ClrHome();
         os_PutStrFull(prompt);
         memset(buf, 0, sizeof(buf));
         os_GetStringInput(NULL, buf, (uint8_t)(sizeof(buf)-1));
-        double v;
+        real v;
         if (parse_number(buf, &v)) return v;
         os_ClrHome(); os_PutStrFull("Invalid number. Any key...");
         while (!os_GetCSC());
@@ -146,25 +391,282 @@ static int prompt_int_hs(const char *prompt) {
 }
 
 /* =================== Pretty Matrix Logger =================== */
-static void log_matrix(double A[MAX_R][MAX_C], int rows, int cols) {
+static void format_row(const real *row, int cols, char out[LINE_CHARS]) {
+    int pos = 0;
+    pos += snprintf(out+pos, LINE_CHARS-pos, "  [");
+    for (int j = 0; j < cols-1 && pos < LINE_CHARS; ++j) {
+        char s[16]; small_val(row[j], s);
+        pos += snprintf(out+pos, LINE_CHARS-pos, " %s", s);
+    }
+    char sb[16]; small_val(row[cols-1], sb);
+    if (pos < LINE_CHARS) snprintf(out+pos, LINE_CHARS-pos, " | %s ]", sb);
+    out[LINE_CHARS-1] = 0;
+}
+
+static void log_matrix(real A[MAX_R][MAX_C], int rows, int cols) {
     log_line("Matrix [A | b]:");
-    for (int i = 0; i < rows; ++i) {
-        char row[LINE_CHARS]; int pos = 0;
-        pos += snprintf(row+pos, LINE_CHARS-pos, "  [");
-        for (int j = 0; j < cols-1; ++j) {
-            char s[16]; small_val(A[i][j], s);
-            pos += snprintf(row+pos, LINE_CHARS-pos, " %s", s);
+    for (int i = 0; i < rows; ++i) log_row(A[i], cols);
+    log_line("");
+}
+
+/* =================== Log text cache =================== */
+static int cache_tag[CACHE_LINES];   /* log line held by each LINECACHE slot */
+
+static void log_cache_clear(void) {
+    for (int i = 0; i < CACHE_LINES; ++i) cache_tag[i] = -1;
+}
+
+static void format_line(int i, char out[LINE_CHARS]) {
+    const log_rec *rec = &LOGRECS[i];
+    const real *v = &LOGVALS[rec->val];
+    if (!rec->fmt) { format_row(v, rec->ints[0], out); return; }
+
+    int pos = 0, ni = 0;
+    for (const char *p = rec->fmt; *p && pos < LINE_CHARS-1; ++p) {
+        if (*p != '%') { out[pos++] = *p; continue; }
+        char s[24];
+        if (*++p == 'd')    snprintf(s, sizeof(s), "%d", rec->ints[ni++]);
+        else if (*p == 'c') { s[0] = (char)rec->ints[ni++]; s[1] = 0; }
+        else if (*p == 'v') small_val(*v++, s);
+        else if (*p == 'e') snprintf(s, sizeof(s), "%.3e", (double)*v++);
+        else if (*p == 'L' || *p == 'U') format_bound(*v++, *p == 'U', s);
+        else if (!*p) break;
+        else                { s[0] = *p; s[1] = 0; }
+        pos += snprintf(out+pos, LINE_CHARS-pos, "%s", s);
+        if (pos > LINE_CHARS-1) pos = LINE_CHARS-1;
+    }
+    out[pos] = 0;
+}
+
+/* line i as text in the current display mode */
+static const char *log_text(int i) {
+    int slot = i % CACHE_LINES;
+    if (cache_tag[slot] != i) { format_line(i, LINECACHE[slot]); cache_tag[slot] = i; }
+    return LINECACHE[slot];
+}
+
+/* overwrite the values of a reserved matrix-row line */
+static void log_set_row(int line, const real *row) {
+    const log_rec *rec = &LOGRECS[line];
+    memcpy(&LOGVALS[rec->val], row, rec->ints[0] * sizeof(real));
+    if (cache_tag[line % CACHE_LINES] == line) cache_tag[line % CACHE_LINES] = -1;
+}
+
+/* =================== Text export =================== */
+/* The whole log as ASCII lines in the GJLOG AppVar, in the current display
+   mode, left in archive. Lines are formatted one at a time into a block of at
+   most LZ_BLOCK bytes that is compressed and written whenever the next line
+   would not fit, so no second copy of the log is held. Blocks end on line
+   boundaries and are compressed independently, so a reader can decode just
+   the blocks it shows:
+
+     "GJZ1", then per block: u16 raw length, u16 packed length, u8 lines, packed
+     and a final header with raw length 0
+
+   The packing is a byte-oriented LZ77: a control byte c < 0x80 is followed by
+   c+1 literals; otherwise bits 2-6 of c plus LZ_MIN bytes are copied from
+   ((c & 3) << 8 | next byte) + 1 back in the same block. Matches are found
+   through a hash chain over 3-byte prefixes, walked at most LZ_CHAIN deep.
+   Logs are mostly short numbers, so expect about half the size.
+   tools/gjlog2txt.py turns the transferred .8xv into a .txt. */
+#define EXPORT_VAR   "GJLOG"
+#define EXPORT_MAGIC "GJZ1"
+#define LZ_BLOCK     1024   /* raw bytes per block; offsets take 10 bits */
+#define LZ_MIN       3
+#define LZ_MAX       (0x1F + LZ_MIN)
+#define LZ_CHAIN     16
+#define LZ_PACKED    (LZ_BLOCK + LZ_BLOCK/128 + 1)  /* all-literal worst case */
+#define LZ_HASH(p)   ((uint8_t)((p)[0] ^ (p)[1] << 2 ^ (p)[2] << 4))
+
+static int lz_pack(const uint8_t *in, int n, uint8_t *out) {
+    static int16_t head[256], prev[LZ_BLOCK];
+    int i = 0, o = 0, lit = -1;     /* lit: control byte of the open literal run */
+
+    memset(head, 0xFF, sizeof(head));
+    while (i < n) {
+        int best = 0, off = 0, tries = LZ_CHAIN;
+        if (i + LZ_MIN <= n)
+            for (int j = head[LZ_HASH(in+i)]; j >= 0 && tries-- && best < LZ_MAX; j = prev[j]) {
+                int len = 0;
+                while (len < LZ_MAX && i+len < n && in[j+len] == in[i+len]) len++;
+                if (len > best) { best = len; off = i - j; }
+            }
+
+        int step = 1;
+        if (best >= LZ_MIN) {
+            out[o++] = (uint8_t)(0x80 | (best - LZ_MIN) << 2 | (off - 1) >> 8);
+            out[o++] = (uint8_t)(off - 1);
+            step = best; lit = -1;
+        } else {
+            if (lit < 0 || out[lit] == 0x7F) { lit = o; out[o++] = 0; }
+            else out[lit]++;
+            out[o++] = in[i];
         }
-        char sb[16]; small_val(A[i][cols-1], sb);
-        pos += snprintf(row+pos, LINE_CHARS-pos, " | %s ]", sb);
-        row[LINE_CHARS-1] = 0;
-        log_line("%s", row);
+        for (; step; --step, ++i)
+            if (i + LZ_MIN <= n) { uint8_t h = LZ_HASH(in+i); prev[i] = head[h]; head[h] = (int16_t)i; }
     }
-    log_line("");
+    return o;
+}
+
+/* -1 if the block is malformed */
+static int lz_unpack(const uint8_t *in, int n, uint8_t *out, int cap) {
+    int i = 0, o = 0;
+    while (i < n) {
+        uint8_t c = in[i++];
+        if (c < 0x80) {
+            if (i + c + 1 > n || o + c + 1 > cap) return -1;
+            memcpy(out + o, in + i, c + 1u);
+            i += c + 1; o += c + 1;
+        } else {
+            int len = (c >> 2 & 0x1F) + LZ_MIN;
+            if (i >= n) return -1;
+            int off = ((c & 3) << 8 | in[i++]) + 1;
+            if (off > o || o + len > cap) return -1;
+            for (; len; --len, ++o) out[o] = out[o - off];
+        }
+    }
+    return o;
+}
+
+static bool export_block(uint8_t h, const uint8_t *raw, int used, int lines) {
+    static uint8_t packed[LZ_PACKED];
+    uint8_t hdr[5];
+    int n = lz_pack(raw, used, packed);
+    hdr[0] = (uint8_t)used; hdr[1] = (uint8_t)(used >> 8);
+    hdr[2] = (uint8_t)n;    hdr[3] = (uint8_t)(n >> 8);
+    hdr[4] = (uint8_t)lines;
+    return ti_Write(hdr, sizeof(hdr), 1, h) == 1 && ti_Write(packed, (size_t)n, 1, h) == 1;
+}
+
+/* the log's blocks and their terminator, at the current position of h */
+static bool log_write_blocks(uint8_t h) {
+    static uint8_t block[LZ_BLOCK];
+    static const uint8_t end[5] = {0};
+    char line[LINE_CHARS];
+    int used = 0, lines = 0;
+    bool ok = true;
+
+    for (int i = 0; i < log_count && ok; ++i) {
+        format_line(i, line);
+        int len = (int)strlen(line);
+        if (used + len + 1 > LZ_BLOCK) {
+            ok = export_block(h, block, used, lines);
+            used = lines = 0;
+        }
+        memcpy(block + used, line, (size_t)len);
+        used += len;
+        block[used++] = '\n';
+        lines++;
+    }
+    if (ok && used) ok = export_block(h, block, used, lines);
+    return ok && ti_Write(end, sizeof(end), 1, h) == 1;
+}
+
+/* archiving can trigger a garbage collect, whose OS prompt needs the LCD
+   back from graphx; afterwards both buffers hold nothing worth keeping */
+static bool gc_ran = false;
+static void gc_before(void) { gfx_End(); }
+static void gc_after(void)  { gfx_Begin(); gfx_SetDrawBuffer(); gc_ran = true; }
+static void gc_none(void)   {}
+
+/* called from the viewer, with graphx running */
+static bool log_export(void) {
+    uint8_t h = ti_Open(EXPORT_VAR, "w");
+    if (!h) return false;
+    bool ok = ti_Write(EXPORT_MAGIC, 4, 1, h) == 1 && log_write_blocks(h);
+    if (ok) {
+        ti_SetGCBehavior(gc_before, gc_after);
+        ti_SetArchiveStatus(true, h);
+        ti_SetGCBehavior(gc_none, gc_none);
+    }
+    ti_Close(h);
+    return ok;
+}
+
+/* =================== Bulk input =================== */
+/* Str0-Str9 hold rows like "2,1,-1,8:-3,-1,2,-11:..." (TI-BASIC has no ';',
+   so ':' or a newline ends a row); L1-L6 hold the cells row-major, 6 for 2x3
+   or 12 for 3x4. Either is streamed from the variable a cell at a time into
+   A, one row per call like the prompts, so the online solver still works
+   while the rest is read. A string holds tokens, not ASCII: the tokens a
+   number can contain are mapped to the characters parse_number expects. */
+static struct {
+    uint8_t h;
+    bool    list;
+    int     cols, left;     /* list cells left */
+} bulk;
+
+/* one string cell; *end is set at a row separator or the end of the string */
+static bool bulk_str_cell(real *out, bool *end) {
+    char num[20];
+    int len = 0, c;
+
+    for (;;) {
+        c = ti_GetC(bulk.h);
+        char ch = c >= 0x30 && c <= 0x39 ? (char)c
+                : c == 0x3A ? '.' : c == 0x3B ? 'e' : c == 0x83 ? '/'
+                : c == 0x71 || c == 0xB0 ? '-' : 0;
+        if (c == 0x29) continue;                    /* space */
+        if (!ch) break;
+        if (len == (int)sizeof(num)-1) return false;
+        num[len++] = ch;
+    }
+    num[len] = 0;
+    *end = c == EOF || c == 0x3E || c == 0x3F;      /* ':' or newline */
+    return (c == 0x2B || *end) && len && parse_number(num, out);
+}
+
+static bool bulk_list_cell(real *out) {
+    real_t r;
+    if (!bulk.left-- || ti_Read(&r, sizeof(r), 1, bulk.h) != 1) return false;
+    *out = os_RealToFloat(&r);
+    return true;
+}
+
+/* row i into A; false (and the variable closed) on malformed data */
+static bool bulk_row(real A[MAX_R][MAX_C], int i) {
+    bool end = false;
+    for (int j = 0; j < bulk.cols; ++j) {
+        bool ok = bulk.list ? bulk_list_cell(&A[i][j]) : bulk_str_cell(&A[i][j], &end);
+        if (!ok || (!bulk.list && end != (j == bulk.cols-1))) { ti_Close(bulk.h); return false; }
+    }
+    if (i == bulk.cols-2) ti_Close(bulk.h);
+    return true;
+}
+
+/* "S0".."S9" or "L1".."L6": open it and read row 0, which sets the size */
+static bool bulk_open(real A[MAX_R][MAX_C], const char *name) {
+    char var[3] = { 0, 0, 0 };
+    char k = name[0] & ~0x20;
+    int  n = name[1] - '0';
+
+    if (name[2] || n < 0 || n > 9) return false;
+    if (k == 'S')                 { var[0] = (char)0xAA; var[1] = (char)(n ? n-1 : 9); }
+    else if (k == 'L' && n && n <= 6) { var[0] = (char)0x5D; var[1] = (char)(n-1); }
+    else return false;
+
+    bulk.list = k == 'L';
+    bulk.h = ti_OpenVar(var, "r", bulk.list ? OS_TYPE_REAL_LIST : OS_TYPE_STR);
+    if (!bulk.h) return false;
+
+    if (bulk.list) {
+        uint16_t dim = 0;
+        ti_Read(&dim, sizeof(dim), 1, bulk.h);
+        bulk.left = dim;
+        bulk.cols = dim == 6 ? 3 : dim == 12 ? 4 : 0;
+        if (!bulk.cols) { ti_Close(bulk.h); return false; }
+        return bulk_row(A, 0);
+    }
+
+    bool end = false;
+    for (bulk.cols = 0; !end; bulk.cols++)
+        if (bulk.cols == MAX_C || !bulk_str_cell(&A[0][bulk.cols], &end)) { ti_Close(bulk.h); return false; }
+    if (bulk.cols < 3) { ti_Close(bulk.h); return false; }
+    return true;
 }
 
 /* =================== Sequential input =================== */
-static void sequential_input(double A[MAX_R][MAX_C], int *rows, int *cols) {
+static void prompt_dims(int *rows, int *cols) {
     int r = prompt_int_hs("Rows? (2 or 3): ");
     int c = prompt_int_hs("Cols? (3 or 4): ");
 
@@ -175,130 +677,1660 @@ static void sequential_input(double A[MAX_R][MAX_C], int *rows, int *cols) {
         r = 2; c = 3;
     }
 
-    for (int i=0;i<r;++i) {
-        for (int j=0;j<c;++j) {
-            char prompt[48];
-            if (j == c-1) snprintf(prompt, sizeof(prompt), "Enter b[%d]: ", i+1);
-            else          snprintf(prompt, sizeof(prompt), "Enter A[%d,%d]: ", i+1, j+1);
-            A[i][j] = prompt_number_hs(prompt);
+    *rows = r; *cols = c;
+}
+
+static void prompt_row(real A[MAX_R][MAX_C], int i, int cols) {
+    for (int j=0;j<cols;++j) {
+        char prompt[48];
+        if (j == cols-1) snprintf(prompt, sizeof(prompt), "Enter b[%d]: ", i+1);
+        else             snprintf(prompt, sizeof(prompt), "Enter A[%d,%d]: ", i+1, j+1);
+        A[i][j] = prompt_number_hs(prompt);
+    }
+}
+
+/* One line per equation, e.g. "2x+3y-Z=5": terms are [+|-][number][*][letter]
+   on either side of a single '=', each followed by +, -, = or the end; a
+   number may be a fraction a/b, a missing one is 1. Letters are
+   case-insensitive and get columns in order of first use, so the first
+   equation names the unknowns (write 0z for an absent one). */
+typedef struct {
+    char names[MAX_R];
+    int  count;
+} eq_vars;
+
+static bool parse_equation(const char *s, eq_vars *v, int limit, real coef[MAX_R], real *rhs) {
+    int side = 1, terms = 0;
+    bool eq = false;
+
+    for (int j = 0; j < MAX_R; ++j) coef[j] = 0.0;
+    *rhs = 0.0;
+    while (*s) {
+        if (*s == ' ') { s++; continue; }
+        if (*s == '=') {
+            if (eq || !terms) return false;
+            eq = true; side = -1; terms = 0; s++;
+            continue;
+        }
+
+        int sign = side;
+        while (*s == '+' || *s == '-' || *s == ' ') if (*s++ == '-') sign = -sign;
+
+        char num[16];
+        int len = 0;
+        while ((*s >= '0' && *s <= '9') || *s == '.' || *s == '/') {
+            if (len == (int)sizeof(num)-1) return false;
+            num[len++] = *s++;
+        }
+        num[len] = 0;
+        if (len && (num[0] == '/' || num[len-1] == '/' || strchr(num, '/') != strrchr(num, '/')))
+            return false;                           /* a/b only */
+        if (*s == '*') { if (!len) return false; s++; }
+
+        real val = 1.0;
+        if (len && !parse_number(num, &val)) return false;
+
+        char c = *s;
+        if (c >= 'a' && c <= 'z') c -= 'a' - 'A';
+        if (c >= 'A' && c <= 'Z') {
+            int j = 0;
+            while (j < v->count && v->names[j] != c) j++;
+            if (j == v->count) {
+                if (v->count == limit) return false;
+                v->names[v->count++] = c;
+            }
+            coef[j] += sign * val;
+            s++;
+        } else if (len) {
+            *rhs -= sign * val;
+        } else {
+            return false;
+        }
+        terms++;
+
+        /* "2X3Y" is not "2X+3Y" */
+        while (*s == ' ') s++;
+        if (*s && *s != '+' && *s != '-' && *s != '=') return false;
+    }
+    return eq && terms;
+}
+
+/* equation i into row i; the first one (limit MAX_R) also fixes the
+   unknowns, or names a variable to read everything from (or LOG) */
+enum { IN_CELLS, IN_TEXT, IN_VAR, IN_SAVED };
+
+static int prompt_equation(real A[MAX_R][MAX_C], int i, eq_vars *v, int limit) {
+    char buf[48], prompt[24];
+    real coef[MAX_R], rhs;
+
+    snprintf(prompt, sizeof(prompt), i ? "Eq %d: " : "Eq %d (ENTER: cells): ", i+1);
+    while (1) {
+        eq_vars seen = *v;
+        os_ClrHome();
+        os_PutStrFull(prompt);
+        memset(buf, 0, sizeof(buf));
+        os_GetStringInput(NULL, buf, (uint8_t)(sizeof(buf)-1));
+        if (i == 0 && !buf[0]) return IN_CELLS;
+        if (i == 0 && !strcmp(buf, "LOG")) return IN_SAVED;
+        if (i == 0 && !strchr(buf, '=') && bulk_open(A, buf)) return IN_VAR;
+        if (parse_equation(buf, &seen, limit, coef, &rhs) && (i || seen.count >= 2)) {
+            *v = seen;
+            for (int j = 0; j < v->count; ++j) A[i][j] = coef[j];
+            A[i][v->count] = rhs;
+            return IN_TEXT;
         }
+        os_ClrHome(); os_PutStrFull("Invalid equation. Any key...");
+        while (!os_GetCSC());
     }
+}
 
-    *rows = r; *cols = c;
+/* =================== Backend cost report =================== */
+/* The same partial-pivoting elimination, silent, in both number types, so
+   each solve can report what long double costs and what it buys. */
+#define DEFINE_PLAIN_GJ(name, T, ABS)                                        \
+static bool name(T M[MAX_R][MAX_C], int n, int cols) {                       \
+    for (int col = 0; col < n; ++col) {                                      \
+        int pivot = col;                                                     \
+        for (int r = col + 1; r < n; ++r)                                    \
+            if (ABS(M[r][col]) > ABS(M[pivot][col])) pivot = r;              \
+        if (M[pivot][col] == 0) return false;                                \
+        for (int j = 0; j < cols; ++j) {                                     \
+            T t = M[pivot][j]; M[pivot][j] = M[col][j]; M[col][j] = t;       \
+        }                                                                    \
+        T inv = 1 / M[col][col];                                             \
+        for (int j = col; j < cols; ++j) M[col][j] *= inv;                   \
+        for (int r = 0; r < n; ++r) {                                        \
+            if (r == col) continue;                                          \
+            T f = M[r][col];                                                 \
+            for (int j = col; j < cols; ++j) M[r][j] -= f * M[col][j];       \
+        }                                                                    \
+    }                                                                        \
+    return true;                                                             \
 }
 
-/* =================== Gauss–Jordan (Verbose) =================== */
-static void gauss_jordan_verbose(double A[MAX_R][MAX_C], int rows, int cols) {
-    int iter = 1;
-    log_line("Initial matrix:");
-    log_matrix(A, rows, cols);
+DEFINE_PLAIN_GJ(plain_gj_double, double, fabs)
+DEFINE_PLAIN_GJ(plain_gj_long, long double, fabsl)
+
+#ifdef GJ_WIDE
+#define PLAIN_GJ_REAL plain_gj_long
+#else
+#define PLAIN_GJ_REAL plain_gj_double
+#endif
+
+typedef struct {
+    long tenth_ms;      /* time per solve, 0.1 ms */
+    real resid;         /* max |A0 x - b|, evaluated in long double */
+} cost_sample;
+
+static bool cost_measure(real A0[MAX_R][MAX_C], int n, int cols, bool wide, cost_sample *out) {
+    double      Md[MAX_R][MAX_C];
+    long double Ml[MAX_R][MAX_C];
+    bool ok = true;
+
+    clock_t t0 = clock();
+    for (int rep = 0; rep < COST_REPS && ok; ++rep) {
+        for (int i = 0; i < n; ++i)
+            for (int j = 0; j < cols; ++j) { Md[i][j] = (double)A0[i][j]; Ml[i][j] = A0[i][j]; }
+        ok = wide ? plain_gj_long(Ml, n, cols) : plain_gj_double(Md, n, cols);
+    }
+    clock_t t1 = clock();
+    if (!ok) return false;
+
+    long double worst = 0;
+    for (int i = 0; i < n; ++i) {
+        long double r = -(long double)A0[i][cols-1];
+        for (int j = 0; j < n; ++j)
+            r += (long double)A0[i][j] * (wide ? Ml[j][cols-1] : (long double)Md[j][cols-1]);
+        if (fabsl(r) > worst) worst = fabsl(r);
+    }
+    out->tenth_ms = (long)(t1 - t0) * 10000L / CLOCKS_PER_SEC / COST_REPS;
+    out->resid = (real)worst;
+    return true;
+}
+
+static void log_cost_report(real A0[MAX_R][MAX_C], int n, int cols) {
+    cost_sample d, l;
+    if (!cost_measure(A0, n, cols, false, &d) || !cost_measure(A0, n, cols, true, &l)) return;
+
+    log_line("Backend: " REAL_NAME);
+    log_line("  double      %d.%d ms/solve, resid %e", (int)(d.tenth_ms / 10), (int)(d.tenth_ms % 10), d.resid);
+    log_line("  long double %d.%d ms/solve, resid %e", (int)(l.tenth_ms / 10), (int)(l.tenth_ms % 10), l.resid);
+    if (d.tenth_ms > 0) {
+        long x10 = l.tenth_ms * 10 / d.tenth_ms;
+        log_line("  long double costs %d.%dx", (int)(x10 / 10), (int)(x10 % 10));
+    }
+    log_line("");
+}
+
+/* =================== Interval bounds =================== */
+/* Each cell becomes [lo, hi] and every operation rounds outward, so the
+   result encloses the exact solution of the system as entered (inputs are
+   widened by an ulp to cover decimal parsing). Each column pivots on the
+   row whose entry has the largest mignitude (smallest |v| over the
+   interval), and every entry is eliminated: nothing is skipped as ~0. */
+typedef struct { real lo, hi; } ival;
+
+/* at least one ulp below/above x, whatever the rounding of the subtraction */
+static real round_down(real x) { return x - (r_fabs(x) * 2 * REAL_EPS + REAL_MIN); }
+static real round_up(real x)   { return x + (r_fabs(x) * 2 * REAL_EPS + REAL_MIN); }
+
+static ival iv_sub(ival a, ival b) {
+    ival r = { round_down(a.lo - b.hi), round_up(a.hi - b.lo) };
+    return r;
+}
+
+static ival iv_mul(ival a, ival b) {
+    real p[4] = { a.lo*b.lo, a.lo*b.hi, a.hi*b.lo, a.hi*b.hi };
+    real lo = p[0], hi = p[0];
+    for (int i = 1; i < 4; ++i) { if (p[i] < lo) lo = p[i]; if (p[i] > hi) hi = p[i]; }
+    ival r = { round_down(lo), round_up(hi) };
+    return r;
+}
+
+/* smallest |v| over a; 0 if a straddles zero */
+static real iv_mig(ival a) {
+    if (a.lo <= 0 && a.hi >= 0) return 0;
+    return a.lo > 0 ? a.lo : -a.hi;
+}
+
+/* false if b straddles zero */
+static bool iv_div(ival a, ival b, ival *out) {
+    if (b.lo <= 0 && b.hi >= 0) return false;
+    ival inv = { round_down(1 / b.hi), round_up(1 / b.lo) };
+    *out = iv_mul(a, inv);
+    return true;
+}
+
+static bool interval_gj(real A0[MAX_R][MAX_C], int n, int cols, ival I[MAX_R][MAX_C]) {
+    for (int i = 0; i < n; ++i)
+        for (int j = 0; j < cols; ++j) { I[i][j].lo = round_down(A0[i][j]); I[i][j].hi = round_up(A0[i][j]); }
 
-    int n = rows; /* left block is n x n */
     for (int col = 0; col < n; ++col) {
+        int p = col;
+        for (int r = col + 1; r < n; ++r)
+            if (iv_mig(I[r][col]) > iv_mig(I[p][col])) p = r;
+        if (p != col)
+            for (int j = 0; j < cols; ++j) { ival t = I[p][j]; I[p][j] = I[col][j]; I[col][j] = t; }
+
+        ival piv = I[col][col];
+        for (int j = col+1; j < cols; ++j) if (!iv_div(I[col][j], piv, &I[col][j])) return false;
+        I[col][col].lo = I[col][col].hi = 1;
+
+        for (int r = 0; r < n; ++r) {
+            if (r == col) continue;
+            ival f = I[r][col];
+            for (int j = col+1; j < cols; ++j) I[r][j] = iv_sub(I[r][j], iv_mul(f, I[col][j]));
+            I[r][col].lo = I[r][col].hi = 0;
+        }
+    }
+    return true;
+}
+
+static void log_interval_bounds(real A0[MAX_R][MAX_C], int n, int cols) {
+    ival I[MAX_R][MAX_C];
+
+    log_line("Interval bounds (outward rounded):");
+    clock_t t0 = clock();
+    bool ok = true;
+    for (int rep = 0; rep < COST_REPS && ok; ++rep) ok = interval_gj(A0, n, cols, I);
+    clock_t t1 = clock();
+    if (!ok) { log_line("  pivot interval contains 0; no bound"); log_line(""); return; }
+
+    real width = 0;
+    for (int i = 0; i < n; ++i) {
+        log_line("  x[%d] in [%L, %U]", i, I[i][cols-1].lo, I[i][cols-1].hi);
+        if (I[i][cols-1].hi - I[i][cols-1].lo > width) width = I[i][cols-1].hi - I[i][cols-1].lo;
+    }
+    log_line("  widest bound %e", width);
+
+    real M[MAX_R][MAX_C];
+    clock_t t2 = clock();
+    for (int rep = 0; rep < COST_REPS; ++rep) {
+        memcpy(M, A0, sizeof(M));
+        PLAIN_GJ_REAL(M, n, cols);
+    }
+    clock_t t3 = clock();
+    if (t3 > t2) {
+        long x10 = (long)(t1 - t0) * 10 / (long)(t3 - t2);
+        log_line("  cost %d.%dx the point solve", (int)(x10 / 10), (int)(x10 % 10));
+    }
+    log_line("");
+}
+
+/* =================== Gauss–Jordan (Online, Verbose) =================== */
+/* Rows are absorbed as soon as they are typed: a new row is reduced against
+   the pivots already established, then every column that has a usable pivot
+   among the rows entered so far is pivoted on. Partial pivoting only sees the
+   entered rows, and once the last row is in only its column's work is left.
+
+   The solver is a resumable state machine: gj_step() does one unit of work
+   (at most one logged operation) so the viewer can produce steps on demand. */
+enum { GJ_REDUCE, GJ_PIVOT, GJ_SCALE, GJ_ELIM, GJ_FINISH, GJ_DONE, GJ_CANCEL };
+
+/* work done by one solve; summarized at the end of the log */
+typedef struct {
+    int  searches;      /* pivot searches */
+    int  swaps, scales, elims;
+    int  skipped;       /* eliminations skipped for a ~0 factor */
+    long madds;         /* scalar multiply-adds in eliminations */
+    long muls;          /* scalar multiplies in scalings */
+    int  divs;          /* divides (LDL^T only; elimination scales by 1/p) */
+} gj_stats;
+
+typedef struct {
+    int rows, cols;
+    int avail;      /* rows entered so far */
+    int col;        /* pivot column being worked; rows [0,col) hold pivots */
+    int phase;
+    int r, k;       /* row cursor, and pivot cursor while reducing */
+    int iter;
+    int init_line;  /* first line of the reserved "Initial matrix" block */
+    int body_line, body_vals;   /* log position just past that block */
+    real A0[MAX_R][MAX_C];  /* input as entered, before elimination */
+    real norm;      /* |A0|_inf of the coefficient rows entered so far */
+    real tol;       /* entries at or below this count as zero */
+    uint8_t row_of[MAX_R];  /* row number each row is indexed under in OPS */
+    char names[MAX_R];      /* letter of each column for typed equations, else 0 */
+    gj_stats stats;
+} gj_state;
+
+/* names: the letter of each unknown, or NULL for cell input */
+static void gj_begin(gj_state *st, int rows, int cols, const char *names) {
+    st->rows = rows; st->cols = cols;
+    st->avail = 0; st->col = 0; st->iter = 1;
+    st->phase = GJ_PIVOT; st->r = 0; st->k = 0;
+    st->norm = 0.0; st->tol = 0.0;
+    for (int i = 0; i < MAX_R; ++i) st->row_of[i] = (uint8_t)(i+1);
+    memset(&st->stats, 0, sizeof(st->stats));
+
+    /* columns follow the letters' first use, not the alphabet */
+    memset(st->names, 0, sizeof(st->names));
+    if (names) {
+        memcpy(st->names, names, rows);
+        if (rows == 2) log_line("Columns: x[0] = %c, x[1] = %c", names[0], names[1]);
+        else           log_line("Columns: x[0] = %c, x[1] = %c, x[2] = %c", names[0], names[1], names[2]);
+        log_line("");
+    }
+
+    /* the initial matrix is only known row by row, so reserve its block */
+    st->init_line = log_count;
+    log_line("Initial matrix:");
+    log_line("Matrix [A | b]:");
+    real zero[MAX_C] = {0};
+    for (int i = 0; i < rows; ++i) log_row(zero, cols);
+    log_line("");
+    st->body_line = log_count; st->body_vals = log_vals;
+}
+
+/* written to the GJSTATS AppVar as CSV with the VARS export, for batch
+   comparisons */
+static bool gj_export_stats(const gj_stats *c) {
+    char buf[112];
+    int len = snprintf(buf, sizeof(buf),
+                       "searches,swaps,scales,elims,skipped,madds,muls,divs\n%d,%d,%d,%d,%d,%ld,%ld,%d\n",
+                       c->searches, c->swaps, c->scales, c->elims, c->skipped, c->madds, c->muls, c->divs);
+    uint8_t h = ti_Open("GJSTATS", "w");
+    if (!h) return false;
+    bool ok = ti_Write(buf, (size_t)len, 1, h) == 1;
+    ti_Close(h);
+    return ok;
+}
+
+/* closing summary: operation counts and the golden-log check */
+static void gj_summary(gj_state *st) {
+    const gj_stats *c = &st->stats;
+    log_line("Operation counts:");
+    log_line("  pivot searches %d, swaps %d", c->searches, c->swaps);
+    log_line("  scalings %d, eliminations %d", c->scales, c->elims);
+    log_line("  skipped ~0 factors %d", c->skipped);
+    log_line("  multiply-adds %d, multiplies %d", (int)c->madds, (int)c->muls);
+    if (c->divs) log_line("  divides %d", c->divs);
+    log_line("  zero tolerance %e", st->tol);
+
+    int at = 0;
+    switch (gold_diff(st->A0, st->rows, st->cols, &at)) {
+    case GOLD_SAME:  log_line("Golden log: identical (%d ops)", op_count); break;
+    case GOLD_DIFF:  log_line("Golden log: diverges at Iter %d", at+1); break;
+    case GOLD_OTHER: log_line("Golden log: saved for another input"); break;
+    }
+}
+
+/* substitute x back into the input (A0) and log each equation's residual;
+   flag those above RESID_TOL times |A0|_inf |x|_inf + |b|_inf */
+static void gj_verify(real A[MAX_R][MAX_C], gj_state *st) {
+    int n = st->rows, cols = st->cols;
+    real norm_a = 0.0, norm_x = 0.0, norm_b = 0.0;
+
+    for (int i = 0; i < n; ++i) {
+        real row = 0.0;
+        for (int j = 0; j < n; ++j) row += r_fabs(st->A0[i][j]);
+        if (row > norm_a) norm_a = row;
+        if (r_fabs(A[i][cols-1]) > norm_x) norm_x = r_fabs(A[i][cols-1]);
+        if (r_fabs(st->A0[i][cols-1]) > norm_b) norm_b = r_fabs(st->A0[i][cols-1]);
+    }
+    real tol = RESID_TOL * (norm_a * norm_x + norm_b);
+
+    log_line("Verification (A x - b, input A):");
+    for (int i = 0; i < n; ++i) {
+        real r = -st->A0[i][cols-1];
+        for (int j = 0; j < n; ++j) r += st->A0[i][j] * A[j][cols-1];
+        if (r_fabs(r) > tol) log_line("  eq %d: %e  <- above tolerance", i+1, r);
+        else               log_line("  eq %d: %e", i+1, r);
+    }
+    log_line("  tolerance %e", tol);
+    log_line("");
+}
+
+/* drop everything logged after the initial matrix, for a path that
+   replaces the online elimination once all rows are in */
+static void gj_rewind(gj_state *st) {
+    log_count = st->body_line; log_vals = st->body_vals;
+    log_cache_clear();
+    op_count = 0;
+    memset(&st->stats, 0, sizeof(st->stats));
+    st->iter = 1;
+}
+
+/* solution and the checks on it; A holds [I | x] */
+static void gj_report(real A[MAX_R][MAX_C], gj_state *st) {
+    int rows = st->rows, cols = st->cols;
+    log_line("Solution x:");
+    for (int i=0;i<rows;++i) log_line("  x[%d] = %v", i, A[i][cols-1]);
+    log_line("");
+    if (VERIFY) gj_verify(A, st);
+    if (INTERVALS) log_interval_bounds(st->A0, rows, cols);
+    if (COST_REPORT) log_cost_report(st->A0, rows, cols);
+}
+
+static void gj_finish(real A[MAX_R][MAX_C], gj_state *st) {
+    log_line("Finished Gauss-Jordan. Expect [I | x].");
+    log_matrix(A, st->rows, st->cols);
+    gj_report(A, st);
+    gj_summary(st);
+}
+
+/* rank of rows [r0, n) over columns [c0, c1), eliminated on a copy */
+static int tail_rank(real A[MAX_R][MAX_C], int r0, int n, int c0, int c1, real tol) {
+    real M[MAX_R][MAX_C];
+    int rank = r0;
+    memcpy(M, A, sizeof(M));
+    for (int c = c0; c < c1 && rank < n; ++c) {
+        int p = rank;
+        for (int r = rank+1; r < n; ++r) if (r_fabs(M[r][c]) > r_fabs(M[p][c])) p = r;
+        if (r_fabs(M[p][c]) <= tol) continue;
+        for (int j = c; j < c1; ++j) { real t = M[p][j]; M[p][j] = M[rank][j]; M[rank][j] = t; }
+        for (int r = rank+1; r < n; ++r) {
+            real f = M[r][c] / M[rank][c];
+            for (int j = c; j < c1; ++j) M[r][j] -= f * M[rank][j];
+        }
+        rank++;
+    }
+    return rank - r0;
+}
+
+/* one unit of work; false when done or waiting for more rows */
+static bool gj_step(real A[MAX_R][MAX_C], gj_state *st) {
+    int n = st->rows, cols = st->cols, m = st->avail; /* left block is n x n */
+    int col = st->col;
+
+    switch (st->phase) {
+    case GJ_REDUCE: {
+        /* bring a newly entered row up to date; pivot row k is zero in the
+           other pivot columns, so each step only clears column k */
+        int i = st->r, k = st->k;
+        if (i >= m) { st->phase = GJ_PIVOT; return true; }
+        if (k >= col) { st->r++; st->k = 0; return true; }
+        st->k++;
+
+        real factor = A[i][k];
+        if (r_fabs(factor) <= st->tol) { st->stats.skipped++; return true; }
+
+        for (int j=k;j<cols;++j) A[i][j] -= factor * A[k][j];
+        st->stats.elims++; st->stats.madds += cols - k;
+
+        index_op(OP_ELIM, st->row_of[i], st->row_of[k], factor);
+        log_line("Iter %d: R%d <- R%d - (%v) * R%d", st->iter++, i+1, i+1, factor, k+1);
+        log_matrix(A, m, cols);
+        return true;
+    }
+
+    case GJ_PIVOT: {
+        if (col >= n) { st->phase = GJ_FINISH; return true; }
+
         /* pivot search */
+        st->stats.searches++;
         int pivot = col;
-        double best = fabs(A[pivot][col]);
-        for (int r = col + 1; r < n; ++r) {
-            double v = fabs(A[r][col]);
+        real best = -1.0;
+        for (int r = col; r < m; ++r) {
+            real v = r_fabs(A[r][col]);
             if (v > best) { best = v; pivot = r; }
         }
-        if (best < EPS) {
-            log_line("Iter %d: ~0 pivot in column %d. Singular/underdetermined.", iter++, col+1);
-            log_matrix(A, rows, cols);
-            return;
+        if (best <= st->tol) {
+            if (m < n) return false; /* wait for more rows */
+            /* rows [col, n) are ~0 up to column col; the rest decides */
+            bool none = tail_rank(A, col, n, col+1, cols, st->tol) > tail_rank(A, col, n, col+1, n, st->tol);
+            index_op(OP_SINGULAR, 0, 0, 0.0);
+            log_line("Iter %d: ~0 pivot in column %d. Singular:", st->iter++, col+1);
+            log_line(none ? "  inconsistent, no solution." : "  dependent, infinitely many solutions.");
+            log_matrix(A, m, cols);
+            gj_summary(st);
+            st->phase = GJ_DONE;
+            return true;
+        }
+
+        /* with rows still missing a later one may hold a better pivot; only
+           commit now if this one is not small against its own row */
+        if (m < n) {
+            real rmax = 0.0;
+            for (int j = col; j < n; ++j) if (r_fabs(A[pivot][j]) > rmax) rmax = r_fabs(A[pivot][j]);
+            if (best < PIVOT_EARLY * rmax) return false;
         }
 
         /* swap */
         if (pivot != col) {
-            log_line("Iter %d: Swap R%d <-> R%d", iter++, col+1, pivot+1);
-            for (int j=0;j<cols;++j) { double t=A[pivot][j]; A[pivot][j]=A[col][j]; A[col][j]=t; }
-            log_matrix(A, rows, cols);
+            index_op(OP_SWAP, st->row_of[col], st->row_of[pivot], 0.0);
+            log_line("Iter %d: Swap R%d <-> R%d", st->iter++, col+1, pivot+1);
+            for (int j=0;j<cols;++j) { real t=A[pivot][j]; A[pivot][j]=A[col][j]; A[col][j]=t; }
+            st->stats.swaps++;
+            log_matrix(A, m, cols);
+        }
+        st->phase = GJ_SCALE;
+        return true;
+    }
+
+    case GJ_SCALE: {
+        real p = A[col][col];
+        if (r_fabs(p) <= st->tol) {
+            index_op(OP_SINGULAR, 0, 0, 0.0);
+            log_line("Iter %d: pivot vanished; abort.", st->iter++);
+            st->phase = GJ_DONE;
+            return true;
         }
+        real inv = 1.0 / p;
+
+        for (int j=col;j<cols;++j) A[col][j] *= inv;
+        st->stats.scales++; st->stats.muls += cols - col;
+
+        index_op(OP_SCALE, st->row_of[col], 0, inv);
+        log_line("Iter %d: Scale R%d by %v (pivot->1)", st->iter++, col+1, inv);
+        log_matrix(A, m, cols);
+        st->phase = GJ_ELIM; st->r = 0;
+        return true;
+    }
+
+    case GJ_ELIM: {
+        /* eliminate other entered rows; later rows are reduced on arrival */
+        int r = st->r++;
+        if (r >= m) { st->col++; st->phase = GJ_PIVOT; return true; }
+        if (r == col) return true;
 
-        /* scale pivot row */
-        {
-            double p = A[col][col];
-            if (fabs(p) < EPS) { log_line("Iter %d: pivot vanished; abort.", iter++); return; }
-            double inv = 1.0 / p;
+        real factor = A[r][col];
+        if (r_fabs(factor) <= st->tol) { st->stats.skipped++; return true; }
 
-            for (int j=col;j<cols;++j) A[col][j] *= inv;
+        for (int j=col;j<cols;++j) A[r][j] -= factor * A[col][j];
+        st->stats.elims++; st->stats.madds += cols - col;
 
-            char invs[16]; small_val(inv, invs);
-            log_line("Iter %d: Scale R%d by %s (pivot->1)", iter++, col+1, invs);
-            log_matrix(A, rows, cols);
+        index_op(OP_ELIM, st->row_of[r], st->row_of[col], factor);
+        log_line("Iter %d: R%d <- R%d - (%v) * R%d", st->iter++, r+1, r+1, factor, col+1);
+        log_matrix(A, m, cols);
+        return true;
+    }
+
+    case GJ_FINISH:
+        gj_finish(A, st);
+        st->phase = GJ_DONE;
+        return true;
+    }
+
+    return false;
+}
+
+/* =================== Block decomposition =================== */
+/* Unknowns that never share an equation split the system into independent
+   blocks (connected components of the variable-equation graph). Each block
+   is solved on its own by gj_step on a sub-state, so the cost is a sum of
+   small cubes and the log is grouped per block. With MAX_R 3 a split system
+   has blocks of at most 2, whose determinant decides up front whether the
+   block path can finish; otherwise the general path carries on. */
+static bool block_try(real A[MAX_R][MAX_C], gj_state *st) {
+    int n = st->rows, b = st->cols-1;
+    int comp[MAX_R], eq_comp[MAX_R], blocks = 0;
+
+    for (int j = 0; j < n; ++j) comp[j] = j;
+    for (int pass = 0; pass < n; ++pass)
+        for (int i = 0; i < n; ++i) {
+            int lo = n;
+            for (int j = 0; j < n; ++j) if (r_fabs(st->A0[i][j]) > st->tol && comp[j] < lo) lo = comp[j];
+            for (int j = 0; j < n; ++j) if (r_fabs(st->A0[i][j]) > st->tol) comp[j] = lo;
         }
+    for (int i = 0; i < n; ++i) {
+        eq_comp[i] = -1;
+        for (int j = 0; j < n; ++j) if (r_fabs(st->A0[i][j]) > st->tol) { eq_comp[i] = comp[j]; break; }
+        if (eq_comp[i] < 0) return false;           /* zero row: leave it to GJ */
+    }
+    for (int j = 0; j < n; ++j) blocks += comp[j] == j;
+    if (blocks < 2) return false;
 
-        /* eliminate other rows */
-        for (int r=0; r<n; ++r) {
-            if (r==col) continue;
-            double factor = A[r][col];
-            if (fabs(factor) < EPS) continue;
+    /* each block must be square and nonsingular */
+    for (int c = 0; c < n; ++c) {
+        int vars[MAX_R], eqs[MAX_R], k = 0, e = 0;
+        for (int j = 0; j < n; ++j) if (comp[j] == c) vars[k++] = j;
+        for (int i = 0; i < n; ++i) if (eq_comp[i] == c) eqs[e++] = i;
+        if (k != e) return false;
+        if (k == 0) continue;
+        if (k == 1) {
+            if (r_fabs(st->A0[eqs[0]][vars[0]]) <= st->tol) return false;
+            continue;
+        }
+        real det = st->A0[eqs[0]][vars[0]] * st->A0[eqs[1]][vars[1]]
+                 - st->A0[eqs[0]][vars[1]] * st->A0[eqs[1]][vars[0]];
+        if (r_fabs(det) <= st->tol * st->norm) return false;    /* norm^2 units */
+    }
 
-            for (int j=col;j<cols;++j) A[r][j] -= factor * A[col][j];
+    gj_rewind(st);
+    log_line("Decoupled into %d independent blocks.", blocks);
+    log_line("");
+
+    for (int c = 0, id = 1; c < n; ++c) {
+        static gj_state sub;
+        int vars[MAX_R], eqs[MAX_R], k = 0, e = 0;
+        for (int j = 0; j < n; ++j) if (comp[j] == c) vars[k++] = j;
+        if (k == 0) continue;
+        for (int i = 0; i < n; ++i) if (eq_comp[i] == c) eqs[e++] = i;
 
-            char fs[16]; small_val(factor, fs);
-            log_line("Iter %d: R%d <- R%d - (%s) * R%d", iter++, r+1, r+1, fs, col+1);
-            log_matrix(A, rows, cols);
+        real B[MAX_R][MAX_C] = {{0}};
+        for (int r = 0; r < k; ++r) {
+            for (int j = 0; j < k; ++j) B[r][j] = st->A0[eqs[r]][vars[j]];
+            B[r][k] = st->A0[eqs[r]][b];
         }
+        memcpy(sub.A0, B, sizeof(B));
+        sub.rows = sub.avail = k; sub.cols = k+1;
+        sub.col = 0; sub.phase = GJ_PIVOT; sub.iter = st->iter;
+        sub.norm = st->norm; sub.tol = st->tol;
+        for (int r = 0; r < k; ++r) sub.row_of[r] = (uint8_t)(eqs[r]+1);  /* search by equation */
+        memset(&sub.stats, 0, sizeof(sub.stats));
+
+        log_line("Block %d (%d x %d):", id++, k, k);
+        for (int r = 0; r < k; ++r) log_line("  R%d = eq %d, column %d = x[%d]", r+1, eqs[r]+1, r+1, vars[r]);
+        log_matrix(B, k, k+1);
+        while (sub.phase == GJ_PIVOT || sub.phase == GJ_SCALE || sub.phase == GJ_ELIM) gj_step(B, &sub);
+
+        for (int r = 0; r < k; ++r) A[vars[r]][b] = B[r][k];
+        st->iter = sub.iter;
+        st->stats.searches += sub.stats.searches; st->stats.swaps += sub.stats.swaps;
+        st->stats.scales += sub.stats.scales; st->stats.elims += sub.stats.elims;
+        st->stats.skipped += sub.stats.skipped;
+        st->stats.madds += sub.stats.madds; st->stats.muls += sub.stats.muls;
     }
 
-    log_line("Finished Gauss-Jordan. Expect [I | x].");
-    log_matrix(A, rows, cols);
-    log_line("Solution x:");
-    for (int i=0;i<rows;++i){ char s[16]; small_val(A[i][cols-1], s); log_line("  x[%d] = %s", i, s); }
+    log_line("Blocks solved. Assembled [I | x].");
+    for (int i = 0; i < n; ++i)
+        for (int j = 0; j < n; ++j) A[i][j] = (i == j);
+    log_matrix(A, n, st->cols);
+    gj_report(A, st);
+    gj_summary(st);
+    st->phase = GJ_DONE;
+    return true;
+}
+
+/* =================== LDL^T fast path =================== */
+/* Symmetry is only known once the last row is in. A symmetric positive
+   definite system is then factored as L D L^T (Cholesky without the square
+   roots, which are slow on the CE) in packed lower-triangular storage, with D
+   on the diagonal: about half the work of elimination and no pivoting. The
+   online elimination done during input is discarded along with its log.
+   A pivot d <= tol means not positive definite; Gauss-Jordan then carries on. */
+#define PK(i, j) ((i)*((i)+1)/2 + (j))     /* j <= i */
+
+static bool ldl_symmetric(const gj_state *st) {
+    for (int i = 1; i < st->rows; ++i)
+        for (int j = 0; j < i; ++j)
+            if (r_fabs(st->A0[i][j] - st->A0[j][i]) > st->tol) return false;
+    return true;
+}
+
+/* factor into P; false with the failing column in *bad */
+static bool ldl_factor(const gj_state *st, real P[MAX_R*(MAX_R+1)/2], int *bad, long *madds) {
+    int n = st->rows;
+    for (int j = 0; j < n; ++j) {
+        real d = st->A0[j][j];
+        for (int k = 0; k < j; ++k) d -= P[PK(j,k)] * P[PK(j,k)] * P[PK(k,k)];
+        *madds += j;
+        if (d <= st->tol) { *bad = j; P[PK(j,j)] = d; return false; }
+        P[PK(j,j)] = d;
+
+        real inv = 1.0 / d;
+        for (int i = j+1; i < n; ++i) {
+            real s = st->A0[i][j];
+            for (int k = 0; k < j; ++k) s -= P[PK(i,k)] * P[PK(j,k)] * P[PK(k,k)];
+            *madds += j;
+            P[PK(i,j)] = s * inv;
+        }
+    }
+    return true;
+}
+
+/* call once every row is absorbed; true if it solved the system */
+static bool ldl_try(real A[MAX_R][MAX_C], gj_state *st) {
+    int n = st->rows, b = st->cols-1, bad = 0;
+    real P[MAX_R*(MAX_R+1)/2], x[MAX_R];
+    long madds = 0;
+
+    if (!ldl_symmetric(st)) return false;
+    if (!ldl_factor(st, P, &bad, &madds)) {
+        log_line("Symmetric, but LDL^T pivot d%d = %v:", bad+1, P[PK(bad,bad)]);
+        log_line("  not positive definite; using Gauss-Jordan.");
+        log_line("");
+        return false;
+    }
+
+    gj_rewind(st);
+    log_line("Symmetric positive definite: A = L D L^T.");
+    for (int j = 0; j < n; ++j) {
+        index_op(OP_FACTOR, st->row_of[j], 0, P[PK(j,j)]);
+        log_line("Iter %d: d%d = %v", st->iter++, j+1, P[PK(j,j)]);
+        for (int i = j+1; i < n; ++i) log_line("  l%d%d = %v", i+1, j+1, P[PK(i,j)]);
+    }
+    log_line("");
+
+    /* L y = b, then D z = y, then L^T x = z, all in x */
+    log_line("Solve L y = b, D z = y, L^T x = z:");
+    for (int i = 0; i < n; ++i) {
+        x[i] = st->A0[i][b];
+        for (int k = 0; k < i; ++k) x[i] -= P[PK(i,k)] * x[k];
+        madds += i;
+        log_line("  y%d = %v", i+1, x[i]);
+    }
+    for (int i = 0; i < n; ++i) x[i] /= P[PK(i,i)];
+    for (int i = n-1; i >= 0; --i)
+        for (int k = i+1; k < n; ++k) x[i] -= P[PK(k,i)] * x[k];
+    madds += n*(n-1)/2;
+    log_line("");
+
+    for (int i = 0; i < n; ++i) {
+        for (int j = 0; j < n; ++j) A[i][j] = (i == j);
+        A[i][b] = x[i];
+    }
+    st->stats.madds = madds; st->stats.muls = n*(n-1)/2; st->stats.divs = 2*n;
+    gj_report(A, st);
+    gj_summary(st);
+    st->phase = GJ_DONE;
+    return true;
+}
+
+/* =================== Row simplification =================== */
+/* Applied to each row as it is absorbed, before it is reduced. A row that is
+   a multiple of an earlier input row adds nothing: it is replaced by what
+   elimination would leave of it, 0 = residual, so the pivot search reports
+   the system singular without doing that elimination. Otherwise an integer
+   row is divided by its content (the gcd of its entries) to keep the
+   intermediates, and the fractions shown for them, small. */
+#define CONTENT_MAX 32767   /* larger integers are left alone */
+
+static long gcd_l(long a, long b) {
+    while (b) { long t = a % b; a = b; b = t; }
+    return a;
+}
+
+static void row_simplify(real A[MAX_R][MAX_C], gj_state *st, int i) {
+    int b = st->cols-1;
+
+    for (int p = 0; p < i; ++p) {
+        int q = 0;
+        while (q < b && r_fabs(st->A0[p][q]) <= st->tol) q++;
+        if (q == b || r_fabs(st->A0[i][q]) <= st->tol) continue;
+
+        real k = st->A0[i][q] / st->A0[p][q];
+        int j = 0;
+        while (j < b && r_fabs(st->A0[i][j] - k * st->A0[p][j]) <= st->tol) j++;
+        if (j < b) continue;
+
+        real rhs = st->A0[i][b] - k * st->A0[p][b];
+        if (r_fabs(rhs) <= st->tol) rhs = 0.0;
+        for (j = 0; j < b; ++j) A[i][j] = 0.0;
+        A[i][b] = rhs;
+        if (k == 1) log_line("R%d duplicates R%d: replaced by 0 = %v", i+1, p+1, rhs);
+        else        log_line("R%d = %v * R%d: replaced by 0 = %v", i+1, k, p+1, rhs);
+        return;
+    }
+
+    long g = 0;
+    for (int j = 0; j <= b; ++j) {
+        real x = A[i][j];
+        if (x != r_floor(x) || r_fabs(x) > CONTENT_MAX) return;
+        g = gcd_l(g, (long)r_fabs(x));
+    }
+    if (g <= 1) return;
+    for (int j = 0; j <= b; ++j) A[i][j] /= g;
+    log_line("R%d / %d (row content)", i+1, (int)g);
+}
+
+/* =================== CPU speed =================== */
+/* Solving and formatting run at 48 MHz. When the viewer has nothing left to
+   compute or redraw it drops to 6 MHz and halts; the keypad and OS timer
+   interrupts wake it to rescan. */
+static void idle_until_key(void) {
+    boot_Set6MHzMode();
+    do {
+        __asm__("halt");
+        kb_Scan();
+    } while (!kb_AnyKey() && !boot_CheckOnPressed());
+    boot_Set48MHzMode();
+}
+
+/* =================== Progress / cancel =================== */
+#define POLL_STEPS 16   /* steps between ON/CLEAR polls; power of two */
+
+static bool viewer_open = false;
+static bool progress_shown = false;
+
+static bool cancel_pressed(void) {
+    kb_Scan();
+    return boot_CheckOnPressed() || (kb_Data[6] & kb_Clear);
+}
+
+static void wait_keys_released(void) {
+    do kb_Scan(); while (kb_AnyKey() || boot_CheckOnPressed());
+}
+
+/* bar over completed pivot columns; drawn straight to the visible screen */
+static void draw_progress(int done, int total) {
+    progress_shown = true;
+    if (viewer_open) {
+        const int x = 40, y = LCD_HEIGHT/2 - 12, w = LCD_WIDTH - 80;
+        gfx_SetDrawScreen();
+        gfx_SetColor(255); gfx_FillRectangle(x-4, y-4, w+8, 30);
+        gfx_SetColor(0);   gfx_Rectangle(x-4, y-4, w+8, 30);
+        gfx_PrintStringXY("Solving... ON/CLEAR cancels", x, y);
+        gfx_Rectangle(x, y+12, w, 10);
+        gfx_FillRectangle(x, y+12, w * done / total, 10);
+        gfx_SetDrawBuffer();
+    } else {
+        char msg[40];
+        snprintf(msg, sizeof(msg), "Solving... %d/%d  ON cancels", done, total);
+        os_ClrHome(); os_PutStrFull(msg);
+    }
+}
+
+/* step until at least `lines` log lines exist, or no more work is possible.
+   Keys are only polled every POLL_STEPS steps, so short runs never see the
+   bar; a cancel leaves the solver in GJ_CANCEL. */
+static void gj_run_to(real A[MAX_R][MAX_C], gj_state *st, int lines) {
+    int steps = 0, shown = -1;
+    while (log_count < lines && gj_step(A, st)) {
+        if ((++steps & (POLL_STEPS-1)) != 0) continue;
+        if (cancel_pressed()) { st->phase = GJ_CANCEL; return; }
+        if (st->col != shown) { shown = st->col; draw_progress(st->col, st->rows); }
+    }
+}
+
+/* call once row st->avail of A has been filled in; the solver must be
+   blocked waiting for rows (run it dry first) */
+static void gj_absorb_row(real A[MAX_R][MAX_C], gj_state *st) {
+    int i = st->avail++;
+
+    memcpy(st->A0[i], A[i], sizeof(A[i]));
+
+    /* the tolerance tracks the norm of what has been entered: it only
+       grows, and is complete before a column can be declared singular */
+    real row = 0.0;
+    for (int j = 0; j < st->cols-1; ++j) row += r_fabs(A[i][j]);
+    if (row > st->norm) st->norm = row;
+    st->tol = TOL_ULPS * st->rows * REAL_EPS * st->norm;
+    disp_zero = st->tol;
+    log_set_row(st->init_line + 2 + i, A[i]);
+    row_simplify(A, st, i);
+    st->phase = GJ_REDUCE; st->r = i; st->k = 0;
+}
+
+/* =================== Key repeat =================== */
+/* Auto-repeat runs off clock(), not off frames: the first repeat comes after
+   REPEAT_DELAY, then the interval shrinks by 1/8 per repeat down to
+   REPEAT_MIN. When a frame runs long every repeat that fell due is returned
+   at once, so scroll speed does not depend on render cost. */
+#define REPEAT_DELAY  (CLOCKS_PER_SEC / 3)
+#define REPEAT_START  (CLOCKS_PER_SEC / 12)
+#define REPEAT_MIN    (CLOCKS_PER_SEC / 100)
+#define REPEAT_BURST  64    /* cap on repeats returned by one call */
+
+typedef struct {
+    uint8_t keys;       /* key group currently held */
+    clock_t next;       /* when the next repeat is due */
+    clock_t interval;
+} key_repeat;
+
+/* presses due for the keys now held: 1 on the initial press, then repeats */
+static int key_repeat_due(key_repeat *kr, uint8_t keys) {
+    clock_t now = clock();
+
+    if (keys != kr->keys) {
+        kr->keys = keys;
+        kr->next = now + REPEAT_DELAY;
+        kr->interval = REPEAT_START;
+        return keys ? 1 : 0;
+    }
+    if (!keys) return 0;
+
+    int n = 0;
+    while (now >= kr->next && n < REPEAT_BURST) {
+        n++;
+        kr->next += kr->interval;
+        if (kr->interval > REPEAT_MIN) kr->interval -= kr->interval / 8;
+    }
+    if (n == REPEAT_BURST) kr->next = now + kr->interval;
+    return n;
+}
+
+/* =================== Student mode =================== */
+#define VIEW_MARGIN 4       /* text layout shared with the viewer below */
+#define VIEW_LINE_H 8
+
+/* Y= in the viewer: the user reduces the input matrix with their own row
+   operations. Each one is applied in O(cols) and judged by how many cells
+   of the left block now agree with the identity. Undo keeps a delta per
+   operation (the row it overwrote) rather than copies of the matrix. */
+#define MAX_UNDO 32
+
+enum { ROW_SWAP, ROW_SCALE, ROW_ADDMUL };
+
+typedef struct {
+    uint8_t kind, a, b;     /* rows, 0-based */
+    real    old[MAX_C];     /* row a before scale/add-multiple */
+} row_delta;
+
+typedef struct {
+    real M[MAX_R][MAX_C];
+    int  rows, cols;
+    real tol;
+    row_delta undo[MAX_UNDO];
+    int  undo_count;        /* oldest entries drop off when full */
+    int  done_cols;         /* leading columns already unit vectors */
+} student_state;
+
+static uint8_t wait_csc(void) {
+    uint8_t k;
+    while (!(k = os_GetCSC()));
+    return k;
+}
+
+/* cells of the left block that already match the identity */
+static int rref_score(const student_state *ss) {
+    int score = 0;
+    for (int i = 0; i < ss->rows; ++i)
+        for (int j = 0; j < ss->rows; ++j)
+            if (r_fabs(ss->M[i][j] - (i == j)) <= ss->tol) score++;
+    return score;
+}
+
+/* An operation only changes rows a and b, so the reduced prefix can only
+   shrink where those rows stop matching it: O(done_cols) per operation. */
+static void student_touch(student_state *ss, int a, int b) {
+    for (int j = 0; j < ss->done_cols; ++j)
+        if (r_fabs(ss->M[a][j] - (a == j)) > ss->tol || r_fabs(ss->M[b][j] - (b == j)) > ss->tol) {
+            ss->done_cols = j;
+            break;
+        }
+}
+
+/* Next operation from the pivot cursor, chosen as gj_step would: largest
+   candidate below the cursor as pivot unless the user already made it 1,
+   scale it to 1, clear the column. */
+static const char *student_hint(student_state *ss, char out[LINE_CHARS]) {
+    real (*M)[MAX_C] = ss->M;
+    char v[16];
+
+    for (int c = ss->done_cols; c < ss->rows; c = ++ss->done_cols) {
+        int pivot = c;
+        real best = -1.0;
+        for (int r = c; r < ss->rows; ++r)
+            if (r_fabs(M[r][c]) > best) { best = r_fabs(M[r][c]); pivot = r; }
+        if (best <= ss->tol) {
+            snprintf(out, LINE_CHARS, "Col %d has no pivot: singular system.", c+1);
+            return out;
+        }
+        if (pivot != c && r_fabs(M[c][c] - 1) > ss->tol) {   /* a pivot of 1 is kept */
+            snprintf(out, LINE_CHARS, "Swap R%d,R%d: largest pivot in col %d.", c+1, pivot+1, c+1);
+            return out;
+        }
+        if (r_fabs(M[c][c] - 1) > ss->tol) {
+            small_val(1 / M[c][c], v);
+            snprintf(out, LINE_CHARS, "Scale R%d by %s to make the pivot 1.", c+1, v);
+            return out;
+        }
+        for (int r = 0; r < ss->rows; ++r)
+            if (r != c && r_fabs(M[r][c]) > ss->tol) {
+                small_val(-M[r][c], v);
+                snprintf(out, LINE_CHARS, "R%d += %s*R%d to clear col %d.", r+1, v, c+1, c+1);
+                return out;
+            }
+    }
+    return "Already in RREF.";
+}
+
+static void student_apply(student_state *ss, int kind, int a, int b, real k) {
+    real *ra = ss->M[a], *rb = ss->M[b];
+
+    if (ss->undo_count == MAX_UNDO) {
+        memmove(ss->undo, ss->undo + 1, (MAX_UNDO-1) * sizeof(row_delta));
+        ss->undo_count--;
+    }
+    row_delta *d = &ss->undo[ss->undo_count++];
+    d->kind = (uint8_t)kind; d->a = (uint8_t)a; d->b = (uint8_t)b;
+    if (kind != ROW_SWAP) memcpy(d->old, ra, ss->cols * sizeof(real));
+
+    for (int j = 0; j < ss->cols; ++j) {
+        if (kind == ROW_SWAP)       { real t = ra[j]; ra[j] = rb[j]; rb[j] = t; }
+        else if (kind == ROW_SCALE) ra[j] *= k;
+        else                        ra[j] += k * rb[j];
+    }
+    student_touch(ss, a, b);
+}
+
+static bool student_undo(student_state *ss) {
+    if (ss->undo_count == 0) return false;
+    row_delta *d = &ss->undo[--ss->undo_count];
+    real *ra = ss->M[d->a], *rb = ss->M[d->b];
+
+    if (d->kind == ROW_SWAP)
+        for (int j = 0; j < ss->cols; ++j) { real t = ra[j]; ra[j] = rb[j]; rb[j] = t; }
+    else
+        memcpy(ra, d->old, ss->cols * sizeof(real));
+    student_touch(ss, d->a, d->b);
+    return true;
+}
+
+/* row number key 1..rows; -1 on CLEAR */
+/* "<what> (1-rows)?"; the row index, or -1 on CLEAR */
+static int ask_row(const char *what, int rows, int y) {
+    char prompt[32];
+    snprintf(prompt, sizeof(prompt), "%s (1-%d)?", what, rows);
+    gfx_PrintStringXY(prompt, VIEW_MARGIN, y);
+    gfx_SwapDraw(); gfx_Blit(gfx_screen);
+    for (;;) {
+        uint8_t k = wait_csc();
+        int r = k == sk_1 ? 0 : k == sk_2 ? 1 : k == sk_3 ? 2 : -2;
+        if (k == sk_Clear) return -1;
+        if (r >= 0 && r < rows) return r;
+    }
+}
+
+/* number typed with digits, '.', (-), '-' and '/'; false on CLEAR */
+static bool ask_number(const char *prompt, real *out, int y) {
+    static const struct { uint8_t key; char ch; } keys[] = {
+        {sk_0,'0'},{sk_1,'1'},{sk_2,'2'},{sk_3,'3'},{sk_4,'4'},{sk_5,'5'},{sk_6,'6'},
+        {sk_7,'7'},{sk_8,'8'},{sk_9,'9'},{sk_DecPnt,'.'},{sk_Chs,'-'},{sk_Sub,'-'},{sk_Div,'/'},
+    };
+    char buf[20] = {0};
+    int len = 0;
+
+    for (;;) {
+        char line[LINE_CHARS];
+        snprintf(line, sizeof(line), "%s%s_ ", prompt, buf);
+        gfx_SetColor(255); gfx_FillRectangle(0, y, LCD_WIDTH, VIEW_LINE_H);
+        gfx_PrintStringXY(line, VIEW_MARGIN, y);
+        gfx_SwapDraw(); gfx_Blit(gfx_screen);
+
+        uint8_t k = wait_csc();
+        if (k == sk_Clear) return false;
+        if (k == sk_Enter && len > 0 && parse_number(buf, out)) return true;
+        if (k == sk_Del && len > 0) buf[--len] = 0;
+        for (unsigned i = 0; i < sizeof(keys)/sizeof(keys[0]); ++i)
+            if (k == keys[i].key && len < (int)sizeof(buf)-1) { buf[len++] = keys[i].ch; break; }
+    }
+}
+
+static void student_mode(real A0[MAX_R][MAX_C], int rows, int cols, real tol) {
+    static student_state ss;
+    static char hint[LINE_CHARS];
+    const char *msg = "Reduce [A | b] to [I | x].";
+    const int menu_y = LCD_HEIGHT - 3*VIEW_LINE_H - VIEW_MARGIN;
+
+    memcpy(ss.M, A0, sizeof(ss.M));
+    ss.rows = rows; ss.cols = cols; ss.tol = tol;
+    ss.undo_count = 0;
+    ss.done_cols = 0;
+
+    for (;;) {
+        char line[LINE_CHARS];
+        int y = VIEW_MARGIN;
+
+        gfx_FillScreen(255);
+        gfx_SetTextFGColor(0);
+        gfx_PrintStringXY("Student mode", VIEW_MARGIN, y);
+        y += 2 * VIEW_LINE_H;
+        for (int i = 0; i < rows; ++i, y += VIEW_LINE_H) {
+            format_row(ss.M[i], cols, line);
+            gfx_PrintStringXY(line, VIEW_MARGIN, y);
+        }
+        y += VIEW_LINE_H;
+        gfx_PrintStringXY(msg, VIEW_MARGIN, y);
+        snprintf(line, sizeof(line), "Identity cells %d/%d, undo %d", rref_score(&ss), rows*rows, ss.undo_count);
+        gfx_PrintStringXY(line, VIEW_MARGIN, y + VIEW_LINE_H);
+        gfx_PrintStringXY("1 Swap  2 Scale  3 Add k*Rb", VIEW_MARGIN, menu_y);
+        gfx_PrintStringXY("4 Hint  DEL undo  CLEAR back", VIEW_MARGIN, menu_y + VIEW_LINE_H);
+        gfx_SwapDraw();
+
+        uint8_t k = wait_csc();
+        if (k == sk_Clear) return;
+        if (k == sk_Del) { msg = student_undo(&ss) ? "Undone." : "Nothing to undo."; continue; }
+        if (k == sk_4)   { msg = student_hint(&ss, hint); continue; }
+        if (k != sk_1 && k != sk_2 && k != sk_3) continue;
+
+        /* prompts go under the menu; blit so both buffers show them */
+        int kind = k == sk_1 ? ROW_SWAP : k == sk_2 ? ROW_SCALE : ROW_ADDMUL;
+        int py = menu_y + 2*VIEW_LINE_H;
+        gfx_SetColor(255); gfx_FillRectangle(0, menu_y, LCD_WIDTH, LCD_HEIGHT - menu_y);
+        int a = ask_row(kind == ROW_SWAP ? "Swap row" : "Target row", rows, menu_y);
+        if (a < 0) continue;
+        int b = a;
+        real f = 1;
+        if (kind != ROW_SCALE && (b = ask_row(kind == ROW_SWAP ? "with row" : "Add k times row", rows, menu_y + VIEW_LINE_H)) < 0) continue;
+        if (kind != ROW_SWAP && !ask_number("k = ", &f, py)) continue;
+        if ((kind == ROW_SWAP || kind == ROW_ADDMUL) && a == b) { msg = "Pick two different rows."; continue; }
+        if (kind == ROW_SCALE && f == 0) { msg = "Scaling by 0 loses the row."; continue; }
+
+        int before = rref_score(&ss);
+        student_apply(&ss, kind, a, b, f);
+        int after = rref_score(&ss);
+        msg = after == rows*rows ? "RREF reached: x is the last column!"
+            : after > before     ? "Closer to RREF."
+            : after == before    ? "No progress; fine if it sets up a pivot."
+            :                      "Further from RREF; DEL undoes it.";
+    }
 }
 
 /* =================== GraphX scroll viewer =================== */
-static void show_log_viewer(void) {
-    const int margin = 4;
-    const int line_h = 8;
-    const int lines_on_screen = (LCD_HEIGHT - 2*margin) / line_h;
+/* Steps are computed lazily: only as far as the page being shown needs,
+   plus a few more in idle frames between key scans.
+
+   The two 8bpp buffers fill LCD RAM, so they double as a two-page cache:
+   each remembers which page it holds, a flip to the page in the back buffer
+   is a single gfx_SwapDraw(), and once the solve is done the idle loop
+   pre-renders the neighbouring page in the paging direction. */
+#define VIEW_LINES  ((LCD_HEIGHT - 2*VIEW_MARGIN) / VIEW_LINE_H - 3)  /* minus header, keys, footer */
+
+typedef struct {
+    int top, count;   /* top line and log_count when rendered; top -1 = stale */
+    bool done;
+    uint8_t disp;     /* display mode and max denominator */
+} page_key;
+
+static bool page_is(const page_key *a, const page_key *b) {
+    return a->top == b->top && a->count == b->count && a->done == b->done && a->disp == b->disp;
+}
+
+static uint8_t disp_key(void) {
+    return (uint8_t)(disp_mode << 4 | disp_den);
+}
+
+static int clamp_top(int top) {
+    if (top > log_count - VIEW_LINES) top = log_count - VIEW_LINES;
+    if (top < 0) top = 0;
+    return top;
+}
+
+/* render page `pk` into the draw buffer */
+static void render_page(const page_key *pk) {
+    const int margin = VIEW_MARGIN, line_h = VIEW_LINE_H;
+
+    gfx_FillScreen(255);
+    gfx_SetTextFGColor(0);
+    gfx_SetTextBGColor(255);
+    gfx_SetTextScale(1,1);
+
+    gfx_PrintStringXY("Gauss-Jordan Steps (UP/DOWN, CLEAR exit)", margin, margin);
+    gfx_PrintStringXY("GRAPH find +/-  STO> golden  Y= student", margin, margin + line_h);
+
+    int y = margin + 2*line_h + 2;
+    int shown = 0;
+    for (int i = pk->top; i < pk->count && shown < VIEW_LINES; ++i, ++shown) {
+        gfx_PrintStringXY(log_text(i), margin, y);
+        y += line_h;
+    }
+
+    char footer[60], disp[16];
+    if (disp_mode == DISP_FRAC || disp_mode == DISP_MIXED)
+        snprintf(disp, sizeof(disp), "%s<=%d", DISP_NAMES[disp_mode], MAX_DENS[disp_den]);
+    else
+        snprintf(disp, sizeof(disp), "%s", DISP_NAMES[disp_mode]);
+    snprintf(footer, sizeof(footer), "Lines %d-%d/%d%s  MODE/2ND %s", pk->top+1, pk->top+shown, pk->count,
+             pk->done ? "" : "+", disp);
+    gfx_PrintStringXY(footer, margin, LCD_HEIGHT - margin - line_h);
+}
+
+/* one-line note over the page; it stays until the page is redrawn */
+static void show_note(const char *msg) {
+    const int x = 24, y = LCD_HEIGHT/2 - 8, w = LCD_WIDTH - 48, h = 16;
+    gfx_SetDrawScreen();
+    gfx_SetColor(255); gfx_FillRectangle(x, y, w, h);
+    gfx_SetColor(0);   gfx_Rectangle(x, y, w, h);
+    gfx_PrintStringXY(msg, x+4, y+4);
+    gfx_SetDrawBuffer();
+}
+
+/* GRAPH opens this over the page; false if CLEAR backs out */
+static bool search_prompt(int *kind, int *row) {
+    const int x = 24, y = LCD_HEIGHT/2 - 24, w = LCD_WIDTH - 48, h = 48;
+    uint8_t k;
+
+    gfx_SetDrawScreen();
+    gfx_SetColor(255); gfx_FillRectangle(x, y, w, h);
+    gfx_SetColor(0);   gfx_Rectangle(x, y, w, h);
+    gfx_PrintStringXY("Find: 1 Swap 2 Scale 3 Elim 4 Any", x+4, y+4);
+    do {
+        k = wait_csc();
+        if (k == sk_Clear) { gfx_SetDrawBuffer(); return false; }
+    } while (k != sk_1 && k != sk_2 && k != sk_3 && k != sk_4);
+    *kind = k == sk_1 ? OP_SWAP : k == sk_2 ? OP_SCALE : k == sk_3 ? OP_ELIM : OP_ANY;
+
+    gfx_PrintStringXY("Row: 1-3, 0 any", x+4, y+16);
+    do {
+        k = wait_csc();
+        if (k == sk_Clear) { gfx_SetDrawBuffer(); return false; }
+    } while (k != sk_0 && k != sk_1 && k != sk_2 && k != sk_3);
+    *row = k == sk_1 ? 1 : k == sk_2 ? 2 : k == sk_3 ? 3 : 0;
+
+    gfx_PrintStringXY("+ next, - previous", x+4, y+32);
+    gfx_SetDrawBuffer();
+    return true;
+}
+
+static bool show_log_viewer(real A[MAX_R][MAX_C], gj_state *st) {
+    const int lines_on_screen = VIEW_LINES;
+    const int idle_steps = 4;
     int top = 0;
+    int page_dir = 1;                   /* last paging direction, for prefetch */
+    page_key front = { -1, 0, false, 0 };  /* page on screen */
+    page_key back  = { -1, 0, false, 0 };  /* page left in the draw buffer */
+    uint8_t disp_keys = 0;                 /* MODE/2ND state, for edges */
+    key_repeat rep = {0}, find_rep = {0};
+    int find_kind = -1, find_row = 0;   /* active search, kind -1 = none */
+    int match = -1;                     /* log line of the current match */
+    bool note = false;                  /* show_note() drew over the front page */
 
     gfx_Begin();
     gfx_SetDrawBuffer();
+    viewer_open = true;
 
     for (;;) {
         kb_Scan();
         if (kb_Data[6] & kb_Clear) break;
-        if (kb_Data[7] & kb_Up)    { if (top > 0) top--; delay(16); }
-        if (kb_Data[7] & kb_Down)  { if (top + lines_on_screen < log_count) top++; delay(16); }
-        if (kb_Data[7] & kb_Left)  { top -= lines_on_screen; if (top < 0) top = 0; delay(60); }
-        if (kb_Data[7] & kb_Right) { top += lines_on_screen; if (top > log_count - lines_on_screen) top = log_count - lines_on_screen; if (top < 0) top = 0; delay(60); }
 
-        gfx_FillScreen(255);
-        gfx_SetTextFGColor(0);
-        gfx_SetTextBGColor(255);
-        gfx_SetTextScale(1,1);
+        uint8_t dir = kb_Data[7] & (kb_Up | kb_Down | kb_Left | kb_Right);
+        bool key = dir != 0;
+        int n = key_repeat_due(&rep, dir);
+        if (n) {
+            if (dir & kb_Up)    top -= n;
+            if (dir & kb_Down)  { gj_run_to(A, st, top + n + lines_on_screen); top += n; }
+            if (dir & kb_Left)  { top -= n * lines_on_screen; page_dir = -1; }
+            if (dir & kb_Right) { gj_run_to(A, st, top + (n+1) * lines_on_screen); top += n * lines_on_screen; page_dir = 1; }
+            top = clamp_top(top);
+        }
 
-        gfx_PrintStringXY("Gauss-Jordan Steps (UP/DOWN, CLEAR exit)", margin, margin);
+        /* search: GRAPH opens the prompt, +/- step between matches; the
+           index only covers computed steps, so finish the solve first */
+        uint8_t fkeys = kb_Data[6] & (kb_Add | kb_Sub);
+        bool find_key = false;
+        if (kb_Data[1] & kb_Graph) {
+            gj_run_to(A, st, INT_MAX);
+            if (search_prompt(&find_kind, &find_row)) { match = top - 1; fkeys = kb_Add; }
+            front.top = -1;
+            rep.keys = find_rep.keys = 0;
+            while (kb_AnyKey()) kb_Scan();
+            find_key = true;
+        } else if (find_kind >= 0 && key_repeat_due(&find_rep, fkeys)) {
+            find_key = true;
+        }
+        if (find_key && find_kind >= 0 && fkeys) {
+            int line = find_op(match, fkeys & kb_Add ? 1 : -1, find_kind, find_row);
+            if (line >= 0) { match = line; top = clamp_top(line); }
+        }
+        key = key || find_key;
 
-        int y = margin + line_h + 2;
-        int shown = 0;
-        for (int i = top; i < log_count && shown < lines_on_screen-2; ++i, ++shown) {
-            gfx_PrintStringXY(LOGBUF[i], margin, y);
-            y += line_h;
+        /* Y= hands the input to the user to reduce themselves */
+        if (kb_Data[1] & kb_Yequ) {
+            student_mode(st->A0, st->rows, st->cols, st->tol);
+            while (kb_AnyKey()) kb_Scan();
+            rep.keys = 0;
+            front.top = back.top = -1;
+            continue;
         }
 
-        char footer[60];
-        snprintf(footer, sizeof(footer), "Lines %d-%d / %d", top+1, top+shown, log_count);
-        gfx_PrintStringXY(footer, margin, LCD_HEIGHT - margin - line_h);
+        /* STO> keeps this solve as the golden op log */
+        if (kb_Data[2] & kb_Sto) {
+            gj_run_to(A, st, INT_MAX);
+            if (st->phase == GJ_DONE)
+                show_note(gold_save(st->A0, st->rows, st->cols) ? "Saved as golden op log" : "Could not save GJGOLD");
+            note = true;
+            while (kb_AnyKey()) kb_Scan();
+            rep.keys = 0;
+            continue;
+        }
 
-        gfx_SwapDraw();
+        /* VARS exports the finished log as text, and its counts as CSV */
+        if (kb_Data[5] & kb_Vars) {
+            gj_run_to(A, st, INT_MAX);
+            if (st->phase == GJ_DONE) {
+                gc_ran = false;
+                bool ok = log_export() && gj_export_stats(&st->stats);
+                if (gc_ran) {       /* redraw the page the collect wiped */
+                    page_key cur = { top, log_count, true, disp_key() };
+                    render_page(&cur);
+                    gfx_SwapDraw();
+                    front = cur; back.top = -1;
+                }
+                show_note(ok ? "Log exported to " EXPORT_VAR ", GJSTATS" : "Could not write " EXPORT_VAR);
+            }
+            note = true;
+            while (kb_AnyKey()) kb_Scan();
+            rep.keys = 0;
+            continue;
+        }
+
+        /* MODE cycles the display mode, 2ND the max denominator; only the
+           lines drawn from now on are reformatted */
+        uint8_t dk = kb_Data[1] & (kb_Mode | kb_2nd);
+        if (dk & ~disp_keys) {
+            if (dk & ~disp_keys & kb_Mode) disp_mode = (disp_mode + 1) % DISP_MODES;
+            if (dk & ~disp_keys & kb_2nd)  disp_den = (disp_den + 1) % N_MAX_DENS;
+            log_cache_clear();
+            key = true;
+        }
+        disp_keys = dk;
+
+        gj_run_to(A, st, top + lines_on_screen);
+        if (!key) for (int i = 0; i < idle_steps && gj_step(A, st); ++i);
+        if (st->phase == GJ_CANCEL) break;
+        if (progress_shown) { progress_shown = false; front.top = -1; }
+        /* a note stays up until the next key, then its buffer is stale */
+        if (note && key) { note = false; front.top = -1; }
+
+        bool done = st->phase == GJ_DONE;
+        page_key want = { top, log_count, done, disp_key() };
+
+        if (!page_is(&front, &want)) {
+            if (!page_is(&back, &want)) { render_page(&want); back = want; }
+            gfx_SwapDraw();
+            page_key t = front; front = back; back = t;
+            continue;
+        }
+        if (key || !done) continue;
+
+        /* idle: prefetch the next page into the back buffer, then sleep
+           until a key instead of spinning on kb_Scan */
+        page_key next = { clamp_top(top + page_dir * lines_on_screen), log_count, done, disp_key() };
+        if (next.top != top && !page_is(&back, &next)) { render_page(&next); back = next; continue; }
+        idle_until_key();
+    }
+
+    viewer_open = false;
+    gfx_End();
+    return st->phase != GJ_CANCEL;
+}
+
+/* =================== Saved log viewer =================== */
+/* "LOG" at the first prompt pages through the exported GJLOG, and a result
+   cache hit through its stored log. Opening only walks the block headers; a
+   page then decodes just the blocks its lines fall in, keeping the last two
+   decoded. */
+#define SAVED_BLOCKS 128
+
+static struct {
+    uint8_t h;
+    int     blocks, lines;
+    uint16_t at[SAVED_BLOCKS];          /* offset of each block's header */
+    int16_t  first[SAVED_BLOCKS + 1];   /* first line of each block */
+    int      slot_block[2];
+    uint8_t  slot[2][LZ_BLOCK];
+    int      slot_len[2], next_slot;
+} saved;
+
+/* blocks starting at offset `at` of var, whose first 4 bytes are magic */
+static bool saved_open(const char *var, const char *magic, uint16_t at) {
+    uint8_t hdr[5];
+    char got[4];
+
+    saved.h = ti_Open(var, "r");
+    if (!saved.h) return false;
+    if (ti_Read(got, 4, 1, saved.h) != 1 || memcmp(got, magic, 4) != 0) {
+        ti_Close(saved.h);
+        return false;
     }
+    ti_Seek(at, SEEK_SET, saved.h);
+    saved.blocks = 0; saved.first[0] = 0;
+    saved.slot_block[0] = saved.slot_block[1] = -1;
+    while (saved.blocks < SAVED_BLOCKS) {
+        at = (uint16_t)ti_Tell(saved.h);
+        if (ti_Read(hdr, sizeof(hdr), 1, saved.h) != 1 || !(hdr[0] | hdr[1])) break;
+        saved.at[saved.blocks] = at;
+        saved.first[saved.blocks + 1] = (int16_t)(saved.first[saved.blocks] + hdr[4]);
+        saved.blocks++;
+        ti_Seek(hdr[2] | hdr[3] << 8, SEEK_CUR, saved.h);
+    }
+    saved.lines = saved.first[saved.blocks];
+    return true;
+}
+
+/* decoded text of block b, or NULL */
+static const uint8_t *saved_block(int b, int *len) {
+    for (int s = 0; s < 2; ++s)
+        if (saved.slot_block[s] == b) { *len = saved.slot_len[s]; return saved.slot[s]; }
+
+    static uint8_t packed[LZ_PACKED];
+    uint8_t hdr[5];
+    int s = saved.next_slot;
+    saved.next_slot ^= 1;
+    saved.slot_block[s] = -1;
+    ti_Seek(saved.at[b], SEEK_SET, saved.h);
+    if (ti_Read(hdr, sizeof(hdr), 1, saved.h) != 1) return NULL;
+    int n = hdr[2] | hdr[3] << 8;
+    if (n > LZ_PACKED || ti_Read(packed, (size_t)n, 1, saved.h) != 1) return NULL;
+    *len = lz_unpack(packed, n, saved.slot[s], LZ_BLOCK);
+    if (*len < 0) return NULL;
+    saved.slot_block[s] = b; saved.slot_len[s] = *len;
+    return saved.slot[s];
+}
+
+static void saved_line(int i, char out[LINE_CHARS]) {
+    int b = 0, len = 0;
+    while (saved.first[b+1] <= i) b++;
+    const uint8_t *p = saved_block(b, &len), *end = p + len;
+
+    out[0] = 0;
+    if (!p) return;
+    for (int skip = i - saved.first[b]; skip && p < end; ++p) if (*p == '\n') skip--;
+    int n = 0;
+    while (p < end && *p != '\n' && n < LINE_CHARS-1) out[n++] = (char)*p++;
+    out[n] = 0;
+}
+
+/* the viewer over an opened saved log */
+static void show_saved_log(const char *title) {
+    key_repeat rep = {0};
+    int top = 0, drawn = -1;
 
+    gfx_Begin();
+    gfx_SetDrawBuffer();
+    for (;;) {
+        kb_Scan();
+        if (kb_Data[6] & kb_Clear) break;
+
+        uint8_t dir = kb_Data[7] & (kb_Up | kb_Down | kb_Left | kb_Right);
+        int n = key_repeat_due(&rep, dir);
+        if (dir & kb_Up)    top -= n;
+        if (dir & kb_Down)  top += n;
+        if (dir & kb_Left)  top -= n * VIEW_LINES;
+        if (dir & kb_Right) top += n * VIEW_LINES;
+        if (top > saved.lines - VIEW_LINES) top = saved.lines - VIEW_LINES;
+        if (top < 0) top = 0;
+
+        if (top != drawn) {
+            char line[LINE_CHARS];
+            int y = VIEW_MARGIN + VIEW_LINE_H + 2, shown = 0;
+            gfx_FillScreen(255);
+            gfx_SetTextFGColor(0);
+            gfx_PrintStringXY(title, VIEW_MARGIN, VIEW_MARGIN);
+            for (int i = top; i < saved.lines && shown < VIEW_LINES; ++i, ++shown, y += VIEW_LINE_H) {
+                saved_line(i, line);
+                gfx_PrintStringXY(line, VIEW_MARGIN, y);
+            }
+            snprintf(line, sizeof(line), "Lines %d-%d / %d", top+1, top+shown, saved.lines);
+            gfx_PrintStringXY(line, VIEW_MARGIN, LCD_HEIGHT - VIEW_MARGIN - VIEW_LINE_H);
+            gfx_SwapDraw();
+            drawn = top;
+        } else if (!dir) {
+            idle_until_key();
+        }
+    }
     gfx_End();
+    ti_Close(saved.h);
+    wait_keys_released();
+}
+
+/* =================== Result cache =================== */
+/* Solved inputs are kept in the archived GJCACHE AppVar, most recently used
+   first, each with its log in the export format:
+
+     "GJC1", u8 count, then per entry: u32 FNV-1a hash, u8 rows, u8 cols,
+     the input cells A0 as reals, the log's blocks and terminator
+
+   The hash covers the dimensions, the exact bytes of every cell and, for
+   typed equations, the letters (the log names them). A candidate's cells
+   are compared in full, so a hit is never a different matrix.
+   A hit skips what is left of the solve (the last row's elimination and the
+   reports, including the cost timing) and shows the stored log. Archive
+   variables cannot be edited in place, so an insert or a move to the front
+   writes a new variable and renames it over the old one; past CACHE_ENTRIES
+   the least recently used entries are dropped. */
+#define CACHE_VAR     "GJCACHE"
+#define CACHE_TMP     "GJCTMP"
+#define CACHE_MAGIC   "GJC1"
+#define CACHE_ENTRIES 8
+
+static uint32_t fnv1a(uint32_t h, const void *p, size_t n) {
+    const uint8_t *b = p;
+    while (n--) { h ^= *b++; h *= 16777619u; }
+    return h;
+}
+
+static uint32_t input_hash(const gj_state *st) {
+    uint8_t dims[2] = { (uint8_t)st->rows, (uint8_t)st->cols };
+    uint32_t h = fnv1a(2166136261u, dims, sizeof(dims));
+    for (int i = 0; i < st->rows; ++i) h = fnv1a(h, st->A0[i], st->cols * sizeof(real));
+    if (st->names[0]) h = fnv1a(h, st->names, st->rows);
+    return h;
+}
+
+/* walk the cache open in h, just past its magic: entry byte ranges, and the
+   index of st's input or -1, with *log where that entry's blocks start */
+static int cache_scan(uint8_t h, const gj_state *st, uint16_t start[], uint16_t end[],
+                      int *count, uint16_t *log) {
+    uint32_t want = input_hash(st);
+    uint8_t n = 0, hdr[5];
+    int hit = -1;
+
+    *count = 0;
+    if (ti_Read(&n, 1, 1, h) != 1) return -1;
+    for (int e = 0; e < n && e < CACHE_ENTRIES; ++e) {
+        uint8_t key[6];
+        start[e] = (uint16_t)ti_Tell(h);
+        if (ti_Read(key, sizeof(key), 1, h) != 1 || key[4] > MAX_R || key[5] > MAX_C) return -1;
+
+        uint32_t hash = key[0] | (uint32_t)key[1] << 8 | (uint32_t)key[2] << 16 | (uint32_t)key[3] << 24;
+        bool same = hit < 0 && hash == want && key[4] == st->rows && key[5] == st->cols;
+        for (int i = 0; i < key[4]; ++i) {
+            real row[MAX_C];
+            if (ti_Read(row, sizeof(real), key[5], h) != key[5]) return -1;
+            same = same && memcmp(row, st->A0[i], key[5] * sizeof(real)) == 0;
+        }
+        if (same) { hit = e; *log = (uint16_t)ti_Tell(h); }
+
+        do {
+            if (ti_Read(hdr, sizeof(hdr), 1, h) != 1) return -1;
+            ti_Seek(hdr[2] | hdr[3] << 8, SEEK_CUR, h);
+        } while (hdr[0] | hdr[1]);
+        end[e] = (uint16_t)ti_Tell(h);
+        *count = e + 1;
+    }
+    return hit;
+}
+
+static bool cache_copy(uint8_t from, uint8_t to, uint16_t start, uint16_t end) {
+    uint8_t buf[64];
+    ti_Seek(start, SEEK_SET, from);
+    while (start < end) {
+        size_t n = end - start < (int)sizeof(buf) ? (size_t)(end - start) : sizeof(buf);
+        if (ti_Read(buf, n, 1, from) != 1 || ti_Write(buf, n, 1, to) != 1) return false;
+        start += n;
+    }
+    return true;
+}
+
+/* rewrite the cache with old entry `first` in front, or st and its log
+   when first is -1; the rest follow in order while there is room */
+static bool cache_rewrite(const gj_state *st, int first) {
+    uint16_t start[CACHE_ENTRIES], end[CACHE_ENTRIES], log;
+    int count = 0;
+    char magic[4];
+
+    uint8_t old = ti_Open(CACHE_VAR, "r");
+    if (old && ti_Read(magic, 4, 1, old) == 1 && memcmp(magic, CACHE_MAGIC, 4) == 0)
+        cache_scan(old, st, start, end, &count, &log);
+
+    uint8_t h = ti_Open(CACHE_TMP, "w"), n = 1;
+    bool ok = h && ti_Write(CACHE_MAGIC, 4, 1, h) == 1 && ti_Write(&n, 1, 1, h) == 1;
+    if (ok && first < 0) {
+        uint32_t hash = input_hash(st);
+        uint8_t key[6] = { (uint8_t)hash, (uint8_t)(hash >> 8), (uint8_t)(hash >> 16),
+                           (uint8_t)(hash >> 24), (uint8_t)st->rows, (uint8_t)st->cols };
+        ok = ti_Write(key, sizeof(key), 1, h) == 1;
+        for (int i = 0; i < st->rows && ok; ++i)
+            ok = ti_Write(st->A0[i], sizeof(real), st->cols, h) == (size_t)st->cols;
+        ok = ok && log_write_blocks(h);
+    } else if (ok) {
+        ok = cache_copy(old, h, start[first], end[first]);
+    }
+    for (int e = 0; e < count && n < CACHE_ENTRIES && ok; ++e)
+        if (e != first) { ok = cache_copy(old, h, start[e], end[e]); n++; }
+    if (ok) { ti_Seek(4, SEEK_SET, h); ok = ti_Write(&n, 1, 1, h) == 1; }
+    if (ok) ti_SetArchiveStatus(true, h);
+
+    if (old) ti_Close(old);
+    if (h) ti_Close(h);
+    if (!ok) { ti_Delete(CACHE_TMP); return false; }
+    ti_Delete(CACHE_VAR);
+    return ti_Rename(CACHE_TMP, CACHE_VAR) == 0;
+}
+
+/* on a hit, move the entry to the front and open its log for viewing */
+static bool cache_open_hit(const gj_state *st) {
+    uint16_t start[CACHE_ENTRIES], end[CACHE_ENTRIES], log = 0;
+    int count, hit = -1;
+    char magic[4];
+
+    for (int pass = 0; pass < 2; ++pass) {
+        uint8_t h = ti_Open(CACHE_VAR, "r");
+        if (!h) return false;
+        if (ti_Read(magic, 4, 1, h) == 1 && memcmp(magic, CACHE_MAGIC, 4) == 0)
+            hit = cache_scan(h, st, start, end, &count, &log);
+        ti_Close(h);
+        if (hit <= 0) break;
+        if (!cache_rewrite(st, hit)) break;     /* then view it where it is */
+    }
+    return hit >= 0 && saved_open(CACHE_VAR, CACHE_MAGIC, log);
 }
 
 /* =================== main =================== */
 int main(void) {
-    double A[MAX_R][MAX_C] = {{0}};
-    int rows=0, cols=0;
+    boot_Set48MHzMode();  /* the OS may have left us in a slower mode */
+
+    /* a cancelled solve goes back to the input screen */
+    for (;;) {
+        real A[MAX_R][MAX_C] = {{0}};
+        int rows=0, cols=0;
+        gj_state st;
+        bool cached = false;
 
-    sequential_input(A, &rows, &cols);
+        eq_vars vars = { {0}, 0 };
+        int src = prompt_equation(A, 0, &vars, MAX_R);
+        if (src == IN_SAVED) {
+            if (saved_open(EXPORT_VAR, EXPORT_MAGIC, 4)) show_saved_log("Saved log (UP/DOWN, CLEAR exit)");
+            else { os_ClrHome(); os_PutStrFull("No saved GJLOG. Any key..."); while (!os_GetCSC()); }
+            continue;
+        }
+        if (src == IN_TEXT)     { rows = vars.count; cols = rows + 1; }
+        else if (src == IN_VAR) { cols = bulk.cols; rows = cols - 1; }
+        else                    prompt_dims(&rows, &cols);
 
-    log_count = 0;
-    gauss_jordan_verbose(A, rows, cols);
-    show_log_viewer();
+        log_count = 0; log_vals = 0; op_count = 0;
+        log_cache_clear();
+        gj_begin(&st, rows, cols, src == IN_TEXT ? vars.names : NULL);
+        for (int i=0;i<rows;++i) {
+            if (src == IN_CELLS)    prompt_row(A, i, cols);
+            else if (i == 0)        ;
+            else if (src == IN_TEXT) prompt_equation(A, i, &vars, rows);
+            else if (!bulk_row(A, i)) {
+                os_ClrHome(); os_PutStrFull("Bad variable data. Any key...");
+                while (!os_GetCSC());
+                st.phase = GJ_CANCEL;
+                break;
+            }
+            gj_absorb_row(A, &st);
+            if (i == rows-1 && cache_open_hit(&st)) { cached = true; break; }
+            if (i == rows-1 && (block_try(A, &st) || ldl_try(A, &st))) break;
+            /* eliminate while the next row is typed; the viewer does the rest */
+            if (i < rows-1) gj_run_to(A, &st, INT_MAX);
+            if (st.phase == GJ_CANCEL) {
+                if (src == IN_VAR) ti_Close(bulk.h);    /* later rows never read */
+                break;
+            }
+        }
+        if (cached) { show_saved_log("Cached solve (UP/DOWN, CLEAR exit)"); break; }
+        if (st.phase != GJ_CANCEL && show_log_viewer(A, &st)) {
+            if (st.phase == GJ_DONE) cache_rewrite(&st, -1);
+            break;
+        }
+        wait_keys_released();
+    }
     return 0;
 }
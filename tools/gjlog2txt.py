@@ -0,0 +1,70 @@
+#!/usr/bin/env python3
+"""Convert a GJLOG.8xv exported by GJSTEP (VARS in the viewer) to plain text.
+
+The AppVar holds "GJZ1" and then compressed blocks; see log_export in
+src/main.c for the format.
+
+usage: gjlog2txt.py GJLOG.8xv [out.txt]
+"""
+import struct
+import sys
+
+HEADER = 55  # "**TI83F*" signature, comment and data length
+
+
+def appvar_data(blob):
+    if blob[:8] != b"**TI83F*":
+        raise ValueError("not a TI-83+/84+ variable file")
+    entry = struct.unpack_from("<H", blob, HEADER)[0]  # 11, or 13 with version/flag
+    data = HEADER + 2 + entry + 2  # past the repeated variable length
+    size = struct.unpack_from("<H", blob, data)[0]  # AppVar's own size word
+    return blob[data + 2 : data + 2 + size]
+
+
+def unpack_block(packed):
+    out = bytearray()
+    i = 0
+    while i < len(packed):
+        c = packed[i]
+        i += 1
+        if c < 0x80:
+            out += packed[i : i + c + 1]
+            i += c + 1
+        else:
+            length = (c >> 2 & 0x1F) + 3
+            off = ((c & 3) << 8 | packed[i]) + 1
+            i += 1
+            for _ in range(length):
+                out.append(out[-off])
+    return bytes(out)
+
+
+def log_text(data):
+    if data[:4] != b"GJZ1":
+        raise ValueError("not a GJSTEP log")
+    text = bytearray()
+    i = 4
+    while i < len(data):
+        raw, size, _lines = struct.unpack_from("<HHB", data, i)
+        block = unpack_block(data[i + 5 : i + 5 + size])
+        if len(block) != raw:
+            raise ValueError("corrupt block at offset %d" % i)
+        text += block
+        i += 5 + size
+    return text.decode("ascii", errors="replace")
+
+
+def main(argv):
+    if len(argv) not in (2, 3):
+        sys.exit(__doc__.strip())
+    with open(argv[1], "rb") as f:
+        text = log_text(appvar_data(f.read()))
+    if len(argv) == 3:
+        with open(argv[2], "w", newline="\n") as f:
+            f.write(text)
+    else:
+        sys.stdout.write(text)
+
+
+if __name__ == "__main__":
+    main(sys.argv)